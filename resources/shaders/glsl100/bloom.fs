@@ -12,28 +12,21 @@ uniform vec4 colDiffuse;
 
 // NOTE: Add here your custom variables
 
-const vec2 size = vec2(800, 450);   // render size
-const float samples = 5.0;          // pixels per axis; higher = bigger glow, worse performance
-const float quality = 2.5;             // lower = smaller glow, better quality
+// Bright pass of the bloom chain, drawn into a target half the size of the scene.
+// The blur passes spread what it keeps and the result is added back over the scene
+uniform vec2 size;                  // Size of the scene texture
+const float threshold = 0.6;        // Brightest channel below this doesn't glow
 
 void main()
 {
-    vec4 sum = vec4(0);
-    vec2 sizeFactor = vec2(1)/size*quality;
-
-    // Texel color fetching from texture sampler
-    vec4 source = texture2D(texture0, fragTexCoord);
-
-    const int range = 2;            // should be = (samples - 1)/2;
-
-    for (int x = -range; x <= range; x++)
-    {
-        for (int y = -range; y <= range; y++)
-        {
-            sum += texture2D(texture0, fragTexCoord + vec2(x, y)*sizeFactor);
-        }
-    }
-
-    // Calculate final fragment color
-    gl_FragColor = ((sum/(samples*samples)) + source)*colDiffuse;
-}
\ No newline at end of file
+    // Averages the 2x2 texels under this fragment so thin bright details aren't skipped
+    vec2 texel = 0.5/size;
+    vec3 color = texture2D(texture0, fragTexCoord + vec2(-texel.x, -texel.y)).rgb;
+    color += texture2D(texture0, fragTexCoord + vec2(texel.x, -texel.y)).rgb;
+    color += texture2D(texture0, fragTexCoord + vec2(-texel.x, texel.y)).rgb;
+    color += texture2D(texture0, fragTexCoord + vec2(texel.x, texel.y)).rgb;
+    color *= 0.25;
+
+    float brightness = max(color.r, max(color.g, color.b));
+    gl_FragColor = vec4(color*max(brightness - threshold, 0.0)/max(brightness, 0.0001), 1.0);
+}
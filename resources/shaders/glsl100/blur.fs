@@ -12,10 +12,11 @@ uniform vec4 colDiffuse;
 
 // NOTE: Add here your custom variables
 
-// NOTE: Render size values must be passed from code
-const float renderWidth = 800.0;
-const float renderHeight = 450.0;
+// One axis of a separable gaussian, run once across and once down.
+// Direction is one texel along that axis: (1/width, 0) or (0, 1/height)
+uniform vec2 direction;
 
+// 9 taps in 5 fetches, the outer ones land between two texels and bilinear filtering weighs them
 vec3 offset = vec3(0.0, 1.3846153846, 3.2307692308);
 vec3 weight = vec3(0.2270270270, 0.3162162162, 0.0702702703);
 
@@ -24,11 +25,11 @@ void main()
     // Texel color fetching from texture sampler
     vec3 tc = texture2D(texture0, fragTexCoord).rgb*weight.x;
 
-    tc += texture2D(texture0, fragTexCoord + vec2(offset.y)/renderWidth, 0.0).rgb*weight.y;
-    tc += texture2D(texture0, fragTexCoord - vec2(offset.y)/renderWidth, 0.0).rgb*weight.y;
+    tc += texture2D(texture0, fragTexCoord + direction*offset.y).rgb*weight.y;
+    tc += texture2D(texture0, fragTexCoord - direction*offset.y).rgb*weight.y;
 
-    tc += texture2D(texture0, fragTexCoord + vec2(offset.z)/renderWidth, 0.0).rgb*weight.z;
-    tc += texture2D(texture0, fragTexCoord - vec2(offset.z)/renderWidth, 0.0).rgb*weight.z;
+    tc += texture2D(texture0, fragTexCoord + direction*offset.z).rgb*weight.z;
+    tc += texture2D(texture0, fragTexCoord - direction*offset.z).rgb*weight.z;
 
     gl_FragColor = vec4(tc, 1.0);
-}
\ No newline at end of file
+}
@@ -13,28 +13,21 @@ out vec4 finalColor;
 
 // NOTE: Add here your custom variables
 
-const vec2 size = vec2(800, 450);   // Framebuffer size
-const float samples = 12;          // Pixels per axis; higher = bigger glow, worse performance
-const float quality = 2.5;          // Defines size factor: Lower = smaller glow, better quality
+// Bright pass of the bloom chain, drawn into a target half the size of the scene.
+// The blur passes spread what it keeps and the result is added back over the scene
+uniform vec2 size;                  // Size of the scene texture
+const float threshold = 0.6;        // Brightest channel below this doesn't glow
 
 void main()
 {
-    vec4 sum = vec4(0);
-    vec2 sizeFactor = vec2(1)/size*quality;
-
-    // Texel color fetching from texture sampler
-    vec4 source = texture(texture0, fragTexCoord);
-
-    const int range = 3;            // should be = (samples - 1)/2;
-
-    for (int x = -range; x <= range; x++)
-    {
-        for (int y = -range; y <= range; y++)
-        {
-            sum += texture(texture0, fragTexCoord + vec2(x, y)*sizeFactor);
-        }
-    }
-
-    // Calculate final fragment color
-    finalColor = ((sum/(samples*samples)) + source)*colDiffuse;
-}
\ No newline at end of file
+    // Averages the 2x2 texels under this fragment so thin bright details aren't skipped
+    vec2 texel = 0.5/size;
+    vec3 color = texture(texture0, fragTexCoord + vec2(-texel.x, -texel.y)).rgb;
+    color += texture(texture0, fragTexCoord + vec2(texel.x, -texel.y)).rgb;
+    color += texture(texture0, fragTexCoord + vec2(-texel.x, texel.y)).rgb;
+    color += texture(texture0, fragTexCoord + vec2(texel.x, texel.y)).rgb;
+    color *= 0.25;
+
+    float brightness = max(color.r, max(color.g, color.b));
+    finalColor = vec4(color*max(brightness - threshold, 0.0)/max(brightness, 0.0001), 1.0);
+}
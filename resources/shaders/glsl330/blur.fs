@@ -13,10 +13,11 @@ out vec4 finalColor;
 
 // NOTE: Add here your custom variables
 
-// NOTE: Render size values must be passed from code
-const float renderWidth = 800;
-const float renderHeight = 450;
+// One axis of a separable gaussian, run once across and once down.
+// Direction is one texel along that axis: (1/width, 0) or (0, 1/height)
+uniform vec2 direction;
 
+// 9 taps in 5 fetches, the outer ones land between two texels and bilinear filtering weighs them
 float offset[3] = float[](0.0, 1.3846153846, 3.2307692308);
 float weight[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
 
@@ -27,9 +28,9 @@ void main()
 
     for (int i = 1; i < 3; i++)
     {
-        texelColor += texture(texture0, fragTexCoord + vec2(offset[i])/renderWidth, 0.0).rgb*weight[i];
-        texelColor += texture(texture0, fragTexCoord - vec2(offset[i])/renderWidth, 0.0).rgb*weight[i];
+        texelColor += texture(texture0, fragTexCoord + direction*offset[i]).rgb*weight[i];
+        texelColor += texture(texture0, fragTexCoord - direction*offset[i]).rgb*weight[i];
     }
 
     finalColor = vec4(texelColor, 1.0);
-}
\ No newline at end of file
+}
@@ -0,0 +1,74 @@
+#include <cstring>
+#include <algorithm>
+#include "atlas.h"
+
+void TextureAtlas::Add(int key, Image image) {
+    Image copy = ImageCopy(image);
+    ImageFormat(&copy, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    pending[key] = copy;
+}
+
+void TextureAtlas::Build() {
+    // Tallest first keeps the shelves tight
+    std::vector<int> order;
+    for (auto &[key, image] : pending) {
+        order.push_back(key);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        if (pending[a].height != pending[b].height) return pending[a].height > pending[b].height;
+        return pending[a].width > pending[b].width;
+    });
+
+    std::vector<Image> pageImages;
+    int x = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (int key : order) {
+        Image &image = pending[key];
+        int width = image.width + atlasPadding;
+        int height = image.height + atlasPadding;
+
+        if (!pageImages.empty() && x + width > pageImages.back().width) {
+            x = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        if (pageImages.empty() || shelfY + height > pageImages.back().height || width > pageImages.back().width) {
+            // Sheets bigger than a page get a page of their own size
+            int pageWidth = std::max(atlasPageSize, width);
+            int pageHeight = std::max(atlasPageSize, height);
+            pageImages.push_back(GenImageColor(pageWidth, pageHeight, BLANK));
+            x = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        Image &page = pageImages.back();
+        unsigned char *pagePixels = (unsigned char *) page.data;
+        unsigned char *imagePixels = (unsigned char *) image.data;
+        for (int row = 0; row < image.height; row++) {
+            memcpy(pagePixels + ((shelfY + row) * page.width + x) * 4, imagePixels + row * image.width * 4, image.width * 4);
+        }
+
+        regions[key] = Region {(int) pageImages.size() - 1, Rectangle {(float) x, (float) shelfY, (float) image.width, (float) image.height}};
+        x += width;
+        shelfHeight = std::max(shelfHeight, height);
+        UnloadImage(image);
+    }
+    pending.clear();
+
+    for (Image &page : pageImages) {
+        pages.push_back(LoadTextureFromImage(page));
+        UnloadImage(page);
+    }
+}
+
+void TextureAtlas::Unload() {
+    for (Texture2D &page : pages) {
+        UnloadTexture(page);
+    }
+    pages.clear();
+    regions.clear();
+}
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include "batch.h"
+
+// Key layout from the top bit: layer (8), texture id (16), depth (16), submission order (24).
+// Depth is biased so negative values sort before positive ones and clamped to what fits
+inline unsigned long long SpriteKey(int layer, unsigned int textureId, int depth, int order) {
+    unsigned int depthBits = (unsigned int) std::clamp(depth, -0x8000, 0x7FFF) + 0x8000;
+    return ((unsigned long long) (layer & 0xFF) << 56) |
+        ((unsigned long long) (textureId & 0xFFFF) << 40) |
+        ((unsigned long long) depthBits << 24) |
+        (unsigned long long) (order & 0xFFFFFF);
+}
+
+void SpriteBatch::Init() {
+    Image pixel = GenImageColor(1, 1, WHITE);
+    whitePixel = LoadTextureFromImage(pixel);
+    UnloadImage(pixel);
+
+    sprites.reserve(1024);
+}
+
+void SpriteBatch::Unload() {
+    UnloadTexture(whitePixel);
+}
+
+void SpriteBatch::Draw(int layer, Texture2D &texture, Rectangle source, Rectangle dest, Color tint, int depth) {
+    sprites.push_back(Sprite {SpriteKey(layer, texture.id, depth, (int) sprites.size()), texture, source, dest, tint});
+}
+
+void SpriteBatch::DrawRect(int layer, Rectangle dest, Color color, int depth) {
+    Draw(layer, whitePixel, {0, 0, 1, 1}, dest, color, depth);
+}
+
+void SpriteBatch::Flush() {
+    std::sort(sprites.begin(), sprites.end(), [](const Sprite &a, const Sprite &b) {
+        return a.key < b.key;
+    });
+
+    unsigned int boundTexture = 0;
+    int quadsInCall = 0;
+
+    for (Sprite &sprite : sprites) {
+        if (sprite.texture.id != boundTexture) {
+            boundTexture = sprite.texture.id;
+            frame.textureBinds++;
+            frame.drawCalls++;
+            quadsInCall = 0;
+        } else if (quadsInCall == maxBatchQuads) {
+            // rlgl flushes its vertex buffer when it fills up
+            frame.drawCalls++;
+            quadsInCall = 0;
+        }
+
+        quadsInCall++;
+        DrawTexturePro(sprite.texture, sprite.source, sprite.dest, {0, 0}, 0, sprite.tint);
+    }
+
+    frame.sprites += (int) sprites.size();
+    sprites.clear();
+}
+
+void SpriteBatch::EndFrame() {
+    Flush();
+    stats = frame;
+    frame = BatchStats {};
+}
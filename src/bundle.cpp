@@ -0,0 +1,73 @@
+#include <cstring>
+#include "bundle.h"
+#include "raylib.h"
+
+// Bytes the decoded asset needs, 0 for anything the packer never writes
+uint64_t EntryDataSize(const BundleEntry &entry) {
+    switch (entry.type) {
+    case BundleImage:
+        if (entry.width <= 0 || entry.height <= 0 || entry.format < PIXELFORMAT_UNCOMPRESSED_GRAYSCALE
+            || entry.format > PIXELFORMAT_UNCOMPRESSED_R32G32B32A32) return 0;
+        return (uint64_t) entry.width * entry.height * GetPixelDataSize(1, 1, (int) entry.format);
+    case BundleWave:
+        if (entry.channels == 0 || (entry.sampleSize != 8 && entry.sampleSize != 16 && entry.sampleSize != 32)) return 0;
+        return (uint64_t) entry.frameCount * entry.channels * (entry.sampleSize / 8);
+    case BundleText:
+        return 1;
+    }
+    return 0;
+}
+
+bool AssetBundle::Open(const char *path) {
+    if (!file.Open(path)) return false;
+    base = file.Data();
+    size = file.Size();
+
+    const BundleHeader *header = (const BundleHeader *) base;
+    if (size < sizeof(BundleHeader) || memcmp(header->magic, bundleMagic, 4) != 0 || header->version != bundleVersion
+        || size < sizeof(BundleHeader) + (uint64_t) header->entryCount * sizeof(BundleEntry)) {
+        Close();
+        return false;
+    }
+
+    // A truncated or stale bundle is rejected whole, the game falls back to the loose files
+    entries = (const BundleEntry *) (base + sizeof(BundleHeader));
+    for (uint32_t index = 0; index < header->entryCount; index++) {
+        const BundleEntry &entry = entries[index];
+        uint64_t expected = EntryDataSize(entry);
+        bool fits = entry.offset <= size && entry.size <= size - entry.offset;
+        if (expected == 0 || !fits || entry.size < expected
+            || (entry.type == BundleText && base[entry.offset + entry.size - 1] != '\0')) {
+            Close();
+            return false;
+        }
+    }
+
+    entryCount = (int) header->entryCount;
+    return true;
+}
+
+void AssetBundle::Close() {
+    file.Close();
+    base = nullptr;
+    entries = nullptr;
+    entryCount = 0;
+    size = 0;
+}
+
+// Entries are sorted by name so this is a binary search
+const BundleEntry *AssetBundle::Find(const char *name) {
+    int low = 0;
+    int high = entryCount - 1;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int order = strncmp(entries[middle].name, name, bundleNameLength);
+        if (order == 0) return &entries[middle];
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    return nullptr;
+}
@@ -0,0 +1,165 @@
+#include "collision.h"
+#include <algorithm>
+#include <cmath>
+
+void TileCollider::Build(TilesetCollection &tilesets, Vector2 _tileSize) {
+    tileSize = _tileSize;
+    hitboxStarts.assign(tilesets.tiles.size() + 1, 0);
+    hitboxes.clear();
+
+    for (int gid = 0; gid < (int) tilesets.tiles.size(); gid++) {
+        hitboxStarts[gid] = (int) hitboxes.size();
+
+        // Tilesets can have bigger or smaller tiles than the map, they are drawn stretched to the cell
+        Rectangle source = tilesets.tiles[gid].source;
+        float scaleX = source.width > 0 ? tileSize.x / source.width : 1;
+        float scaleY = source.height > 0 ? tileSize.y / source.height : 1;
+        for (const Rectangle &rect : tilesets.GetHitboxes(gid)) {
+            hitboxes.push_back(Rectangle {rect.x * scaleX, rect.y * scaleY, rect.width * scaleX, rect.height * scaleY});
+        }
+    }
+    hitboxStarts.back() = (int) hitboxes.size();
+}
+
+bool TileCollider::Overlaps(Layer &layer, Rectangle box) {
+    int left = std::max(0, (int) floorf(box.x / tileSize.x));
+    int top = std::max(0, (int) floorf(box.y / tileSize.y));
+    int right = std::min(layer.width - 1, (int) floorf((box.x + box.width) / tileSize.x));
+    int bottom = std::min(layer.height - 1, (int) floorf((box.y + box.height) / tileSize.y));
+
+    for (int y = top; y <= bottom; y++) {
+        for (int x = left; x <= right; x++) {
+            Tile *tile = layer.Getat(Vector2 {(float) x, (float) y});
+            if (tile == nullptr || tile->Gid() + 1 >= (int) hitboxStarts.size()) continue;
+
+            for (int index = hitboxStarts[tile->Gid()]; index < hitboxStarts[tile->Gid() + 1]; index++) {
+                Rectangle hitbox = FlipHitbox(hitboxes[index], *tile);
+                hitbox.x += x * tileSize.x;
+                hitbox.y += y * tileSize.y;
+                if (box.x < hitbox.x + hitbox.width && box.x + box.width > hitbox.x
+                    && box.y < hitbox.y + hitbox.height && box.y + box.height > hitbox.y) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Walks the rows the sweep crosses and, in each, only the columns the box covers while it is
+// inside that row, so a long diagonal move doesn't visit its whole bounding rectangle
+TileHit TileCollider::Sweep(Layer &layer, Rectangle box, Vector2 move) {
+    TileHit best;
+    best.position = Vector2 {box.x + move.x, box.y + move.y};
+    if (move.x == 0 && move.y == 0) return best;
+
+    int firstRow = std::max(0, (int) floorf(std::min(box.y, box.y + move.y) / tileSize.y));
+    int lastRow = std::min(layer.height - 1, (int) floorf((std::max(box.y, box.y + move.y) + box.height) / tileSize.y));
+
+    for (int y = firstRow; y <= lastRow; y++) {
+        float enter = 0;
+        float exit = 1;
+        if (move.y != 0) {
+            float reachTop = (y * tileSize.y - box.height - box.y) / move.y;
+            float leaveBottom = ((y + 1) * tileSize.y - box.y) / move.y;
+            enter = std::max(0.0f, std::min(reachTop, leaveBottom));
+            exit = std::min(1.0f, std::max(reachTop, leaveBottom));
+            if (enter > exit || enter >= best.time) continue;
+        }
+
+        float left = box.x + move.x * (move.x < 0 ? exit : enter);
+        float right = box.x + box.width + move.x * (move.x < 0 ? enter : exit);
+        int firstColumn = std::max(0, (int) floorf(left / tileSize.x));
+        int lastColumn = std::min(layer.width - 1, (int) floorf(right / tileSize.x));
+        for (int x = firstColumn; x <= lastColumn; x++) {
+            SweepTile(layer, x, y, box, move, best);
+        }
+    }
+    return best;
+}
+
+TileHit TileCollider::Move(Layer &layer, Rectangle &box, Vector2 move, int maxSlides) {
+    TileHit last;
+    for (int slide = 0; slide < maxSlides && (move.x != 0 || move.y != 0); slide++) {
+        TileHit hit = Sweep(layer, box, move);
+        box.x = hit.position.x;
+        box.y = hit.position.y;
+        if (!hit.hit) break;
+
+        // Whatever is left of the move carries on along the surface
+        last = hit;
+        move = Vector2 {move.x * (1 - hit.time), move.y * (1 - hit.time)};
+        if (hit.normal.x != 0)
+            move.x = 0;
+        else
+            move.y = 0;
+    }
+    return last;
+}
+
+void TileCollider::MoveAll(Layer &layer, Rectangle *boxes, const Vector2 *moves, TileHit *hits, int count) {
+    for (int index = 0; index < count; index++) {
+        TileHit hit = Move(layer, boxes[index], moves[index]);
+        if (hits != nullptr) hits[index] = hit;
+    }
+}
+
+// Same order as drawing, the diagonal flip swaps the axes before the other two mirror them
+Rectangle TileCollider::FlipHitbox(Rectangle hitbox, Tile tile) {
+    if (tile.FlippedDiagonally()) {
+        float ratio = tileSize.x / tileSize.y;
+        hitbox = Rectangle {hitbox.y * ratio, hitbox.x / ratio, hitbox.height * ratio, hitbox.width / ratio};
+    }
+    if (tile.FlippedX()) hitbox.x = tileSize.x - hitbox.x - hitbox.width;
+    if (tile.FlippedY()) hitbox.y = tileSize.y - hitbox.y - hitbox.height;
+    return hitbox;
+}
+
+// Sweeps the box's top left corner as a point against each hitbox grown by the box's size
+void TileCollider::SweepTile(Layer &layer, int x, int y, Rectangle box, Vector2 move, TileHit &best) {
+    Tile *tile = layer.Getat(Vector2 {(float) x, (float) y});
+    if (tile == nullptr || tile->Gid() + 1 >= (int) hitboxStarts.size()) return;
+
+    for (int index = hitboxStarts[tile->Gid()]; index < hitboxStarts[tile->Gid() + 1]; index++) {
+        Rectangle hitbox = FlipHitbox(hitboxes[index], *tile);
+        float minX = x * tileSize.x + hitbox.x - box.width;
+        float maxX = x * tileSize.x + hitbox.x + hitbox.width;
+        float minY = y * tileSize.y + hitbox.y - box.height;
+        float maxY = y * tileSize.y + hitbox.y + hitbox.height;
+
+        // Sliding along a face is not a hit, the box has to be strictly between on a still axis
+        float enterX = -INFINITY, exitX = INFINITY;
+        if (move.x != 0) {
+            enterX = std::min((minX - box.x) / move.x, (maxX - box.x) / move.x);
+            exitX = std::max((minX - box.x) / move.x, (maxX - box.x) / move.x);
+        } else if (box.x <= minX || box.x >= maxX) {
+            continue;
+        }
+
+        float enterY = -INFINITY, exitY = INFINITY;
+        if (move.y != 0) {
+            enterY = std::min((minY - box.y) / move.y, (maxY - box.y) / move.y);
+            exitY = std::max((minY - box.y) / move.y, (maxY - box.y) / move.y);
+        } else if (box.y <= minY || box.y >= maxY) {
+            continue;
+        }
+
+        float enter = std::max(enterX, enterY);
+        float exit = std::min(exitX, exitY);
+        if (enter > exit || enter < 0 || exit <= 0 || enter >= best.time) continue;
+
+        best.hit = true;
+        best.time = enter;
+        best.tileX = x;
+        best.tileY = y;
+        best.gid = tile->Gid();
+        best.position = Vector2 {box.x + move.x * enter, box.y + move.y * enter};
+
+        // Snapped so the next sweep starts exactly on the face instead of a rounding error inside it
+        if (enterX > enterY) {
+            best.normal = Vector2 {move.x > 0 ? -1.0f : 1.0f, 0};
+            best.position.x = move.x > 0 ? minX : maxX;
+        } else {
+            best.normal = Vector2 {0, move.y > 0 ? -1.0f : 1.0f};
+            best.position.y = move.y > 0 ? minY : maxY;
+        }
+    }
+}
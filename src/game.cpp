@@ -1,20 +1,34 @@
 #include <time.h>
+#include <cstring>
 #include "game.h"
 #include "tractor.h"
 #include "shop.h"
 #include "easing.h"
 #include "web.h"
 #include "base.h"
+#include "atlas.h"
+#include "loader.h"
+#include "bundle.h"
+#include "post.h"
 
 ApplicationStates appState = Loading;
 
-std::map<Textures, const char*> texturesToLoad;
-std::map<Textures, Texture2D> loadedTextures;
-std::map<Sounds, const char*> soundsToLoad;
-std::map<Sounds, Sound> loadedSounds;
-std::map<Fonts, JakeFont> loadedFonts;
+AssetArray<Textures, Texture2D, totalTextures> loadedTextures("Texture");
+Rectangle textureRects[totalTextures];
+SpriteHandles spriteHandles;
+TextureAtlas atlas;
+AssetLoader loader;
+AssetBundle bundle;
+bool gameAssetsReady = false;
+
+enum AssetGroups {
+    TitleAssets,
+    GameAssets
+};
+AssetArray<Sounds, Sound, totalSounds> loadedSounds("Sound");
+AssetArray<Fonts, JakeFont, totalFonts> loadedFonts("Font");
 
-int sw, sh;
+int sw = 320, sh = 200;
 int gameTime;
 int pauseBtnSwitchTimer;
 int pauseBtnTimer;
@@ -42,6 +56,7 @@ InterpolationFunction menuArrowAnim = {InterpolationFunction::EaseInOut, 15};
 
 float initialItemVel = 0.8;
 const int groundStartY = 9 * tileHeight;
+const int explosionFrameDuration = 5;
 
 GameData game;
 Color playAgainColor;
@@ -49,58 +64,96 @@ Camera2D cam;
 Tractor trac;
 Animation coinAnimation;
 RenderTexture2D target;
-
-std::map<Shaders, Shader> shaders;
-Shaders nextShader = Shaders::None;
-
-std::vector<FallingItem> fallingItems;
-std::vector<Particle*> particles;
-std::vector<Particle*> explosionParticles;
+RenderTexture2D canvas;             // The game world at one texel per world pixel, scaled up in one blit
+bool lowResCanvas = true;
+bool frameInTarget = false;
+SpriteBatch batch;
+PostChain post;
+FixedStep fixedStep;
+double lastFrameTime;
+bool showStats = false;
+
+EffectSet nextEffects = 0;
+
+ItemStore fallingItems;
+ItemEvents itemEvents;
+std::vector<Sounds> tickSounds;     // Asked for by the ticks of this frame, played once they've run
+Pool<ScoreParticle, maxScoreParticles> particles;
+Pool<ExplosionParticle, maxExplosionParticles> explosionParticles;
 std::vector<Transition*> transitions;
 std::vector<Effect> effects;
 
-void InitGame();
 void EndGame();
-void UpdateGame();
-void UpdateItems(bool countCoins=false, bool moveItems=false);
+void UpdateGame(float alpha);
+void StepItems(bool countCoins);
+void DrawItems(Camera2D worldCam, float alpha);
+void StepParticles();
+void PrintPoolStats();
+void PrintShaderStats();
+void PlayTickSounds();
+void DrawStats();
 void UpdateEffects();
-void OnInCart(FallingItem &item, Rectangle cartRect);
-void OnHitGround(FallingItem &item, Rectangle cartRect);
+void OnInCart(int id, Vector2 pos, Rectangle cartRect);
+void OnHitGround(int id, Vector2 pos, Rectangle cartRect);
 void SpawnNewItems();
 
 void InitTitleScreen();
-void UpdateTitleScreen();
+void StepTitleScreen();
+void UpdateTitleScreen(float alpha);
 void SpawnTitleScreenItems(bool randomY=false);
 
 void InitGameOverScreen();
+void StepGameOverScreen();
 void UpdateGameOverScreen();
 void InitMenu();
 void UpdateMenu();
 
-void UpdateTransitions();
+void TickApp(TickInput input);
+void StepTransitions();
+void DrawTransitions();
 void UpdateScreenSize();
+void BeginScreen(bool shaded);
+void EndScreen();
+void DrawWorld(Camera2D worldCam, float alpha);
+void DrawCanvas();
+void ResizeCanvas();
 
-void LoadShaders();
 void PreloadAssets();
+void QueueTexture(AssetGroups group, Textures name, const char *path);
+void QueueSprite(Textures name, const char *path);
+void QueueSound(AssetGroups group, Sounds name, const char *path);
 void UnloadAssets();
+Image LoadBundledImage(const char *path);
+std::string LoadEffectSource(const char *fileName);
 bool IsDoneLoadingAssets();
+void StreamAssets();
+void FinishLoadingAssets();
 
 int GetPointValueFromId(int id, bool onGround=false);
 float GetVelFromCoins(int coins);
 bool InShaderMode();
 
+// The bench links the game without its window loop, see "make bench"
+#if !defined(HEADLESS)
 int main() {
+    SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(1280, 800, "Long Wagon - Jake");
     InitAudioDevice();
     SetTraceLogLevel(LOG_ERROR);
     SetExitKey(KEY_NULL);
-    SetTargetFPS(60);
+
+    // Render at the display rate, the simulation keeps its own fixed tick
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(refreshRate > 0 ? refreshRate : tickRate);
+    batch.Init();
+    bundle.Open(bundlePath);
+    post.Init(LoadEffectSource);
     PreloadAssets(); 
     SetConfigFlags(FLAG_MSAA_4X_HINT);
     target = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
     
     int id = GetRandomValue(fruitIds.x, fruitIds.y);
-    Image iconImage = LoadImage("resources/img/items.png");
+    Image iconImage = LoadBundledImage("resources/img/items.png");
     Image iconSource = ImageFromImage(iconImage, GetSourceRect(id, {(float) iconImage.width, (float) iconImage.height}, 16, 16));
     SetWindowIcon(iconSource);
 
@@ -108,12 +161,35 @@ int main() {
     coinAnimation = Animation({0, 1, 2, 3, 4}, {120, 6, 6, 6, 6}, true);
 
     while (!WindowShouldClose()) {
+        double now = GetTime();
+        float frameTime = now - lastFrameTime;
+        lastFrameTime = now;
+
+        if (IsKeyPressed(KEY_F3)) showStats = !showStats;
+        if (IsKeyPressed(KEY_F4)) lowResCanvas = !lowResCanvas;
+
+        if (appState != ApplicationStates::Loading) {
+            StreamAssets();
+            PrepareTractorSprites(game.colors[game.selectedColor]);
+
+            TickInput input = PollTickInput();
+            int ticks = fixedStep.Advance(frameTime);
+            for (int tick = 0; tick < ticks; tick++) {
+                TickApp(input);
+            }
+            PlayTickSounds();
+        }
+
+        float alpha = fixedStep.Alpha();
+
         switch (appState)
         {
         case ApplicationStates::Loading:
             if (IsDoneLoadingAssets()) {
                 InitTitleScreen();
                 appState = ApplicationStates::TitleScreen;
+                fixedStep.Reset();
+                lastFrameTime = GetTime();
 
                 if (GetRandomValue(0, 100) == 0)
                     PlaySound(GetSound(Sounds::ExtraLongWagonVoice));
@@ -125,27 +201,68 @@ int main() {
             UpdateGameOverScreen();
             break;
         case ApplicationStates::TitleScreen:
-            UpdateTitleScreen();
+            UpdateTitleScreen(alpha);
             break;
         case ApplicationStates::Running:
-            UpdateGame();
+            UpdateGame(alpha);
             break;
         }
 
-        if (InShaderMode()) {
+        batch.EndFrame();
+
+        if (frameInTarget) {
+            post.Prepare(game.selectedEffects, target);
             BeginDrawing();
-                BeginShaderMode(shaders[game.selectedShader]);
-                    DrawTextureRec(target.texture, {0, 0, (float)target.texture.width, (float)-target.texture.height}, {0, 0}, WHITE);
-                EndShaderMode();
+                post.Draw(Rectangle {0, 0, (float) GetScreenWidth(), (float) GetScreenHeight()});
             EndDrawing();
         }
 
-        if (nextShader != game.selectedShader) {
-            game.selectedShader = nextShader;
+        post.CompilePending();
+        if (nextEffects != game.selectedEffects) {
+            game.selectedEffects = nextEffects;
         }
     }
 
+    loader.Stop();
+    batch.Unload();
+    post.Unload();
+    UnloadTractorSprites();
     UnloadAssets();
+    bundle.Close();
+    PrintPoolStats();
+    PrintShaderStats();
+}
+#endif
+
+void TickApp(TickInput input) {
+    switch (appState)
+    {
+    case ApplicationStates::GameOver:
+        StepGameOverScreen();
+        break;
+    case ApplicationStates::TitleScreen:
+        StepTitleScreen();
+        break;
+    case ApplicationStates::Running:
+        StepGame(input);
+        break;
+    default:
+        break;
+    }
+
+    StepShop();
+    StepTransitions();
+}
+
+TickInput PollTickInput() {
+    TickInput input;
+    input.right = (IsKeyDown(KEY_D) && !IsKeyDown(KEY_A)) || (IsKeyDown(KEY_RIGHT) && !IsKeyDown(KEY_LEFT));
+    input.left = (IsKeyDown(KEY_A) && !IsKeyDown(KEY_D)) || (IsKeyDown(KEY_LEFT) && !IsKeyDown(KEY_RIGHT));
+    input.up = IsKeyDown(KEY_W) && !IsKeyDown(KEY_S);
+    input.down = IsKeyDown(KEY_S) && !IsKeyDown(KEY_W);
+    input.pointerDown = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+    input.pointerX = GetMousePosition().x;
+    return input;
 }
 
 /* ------------- Main Game ------------- */
@@ -165,10 +282,11 @@ void InitGame() {
     trac.Init(sw, cam, groundStartY);
     nextItemTime = GetRandomValue(0, 120);
     coinAnimation.Reset();
-    fallingItems.clear();
+    fallingItems.Clear();
     effects.clear();
-    clearHeapVector(particles);
-    clearHeapVector(explosionParticles);
+    particles.Clear();
+    explosionParticles.Clear();
+    tickSounds.clear();
 
     menuOpen = false;
     menuInAnim = 0;
@@ -180,10 +298,12 @@ void EndGame() {
     game.inGameCoins = 0;
 }
 
-void UpdateGame() {
-    // DEBUG NOT FINAL
-    if (IsKeyDown(KEY_J) && IsKeyDown(KEY_A) && IsKeyDown(KEY_K) && IsKeyPressed(KEY_E)) {
-        game.inGameCoins += 100;
+// Advances the world by one fixed tick, doesn't touch the window so it can run headless
+void StepGame(TickInput input) {
+    if (gameOver && isTransitionFinished("fade-gameover")) {
+        appState = ApplicationStates::GameOver;
+        InitGameOverScreen();
+        return;
     }
 
     if (currentHealth <= 0 && !gameOver) {
@@ -193,6 +313,32 @@ void UpdateGame() {
     }
 
     gameTime++;
+
+    trac.StorePrevious();
+    fallingItems.StorePrevious();
+
+    if (!menuOpen) {
+        trac.Update(cam, game, input, sw, !gameOver, inLightningMode ? game.speedUpgrade.values[game.speedUpgrade.unlocked] + 2 : -1);
+        trac.Animate();
+        trac.UpdateParticles();
+        coinAnimation.Update();
+        StepItems(!gameOver);
+    }
+
+    if (!gameOver && !menuOpen) {
+        SpawnNewItems();
+    }
+
+    StepParticles();
+    UpdateEffects();
+}
+
+void UpdateGame(float alpha) {
+    // DEBUG NOT FINAL
+    if (IsKeyDown(KEY_J) && IsKeyDown(KEY_A) && IsKeyDown(KEY_K) && IsKeyPressed(KEY_E)) {
+        game.inGameCoins += 100;
+    }
+
     UpdateScreenSize();
     
     if (IsKeyPressed(KEY_ESCAPE) && !gameOver) {
@@ -207,72 +353,56 @@ void UpdateGame() {
         }
     }
 
-    if (InShaderMode()) BeginTextureMode(target); else BeginDrawing();
-    
-        ClearBackground(BLACK);
-
-        Texture2D &mapTexture = GetTexture(game.selectedMap);
-        DrawTexturePro(mapTexture, {0, 0, (float) mapTexture.width, (float) mapTexture.height}, {0, 0, (float) GetScreenWidth(), (float) GetScreenHeight()}, {0, 0}, 0, WHITE);
+    if (lowResCanvas) {
+        // Drawn before the frame starts since raylib can't nest texture modes
+        ResizeCanvas();
+        Camera2D worldCam = cam;
+        worldCam.zoom = 1;
 
-        if (!menuOpen) {
-            trac.Update(cam, game, !gameOver, inLightningMode ? game.speedUpgrade.values[game.speedUpgrade.unlocked] + 2 : -1);
-        }
+        BeginTextureMode(canvas);
+            ClearBackground(BLACK);
+            DrawWorld(worldCam, alpha);
+            batch.Flush();
+        EndTextureMode();
 
-        UpdateItems(!gameOver, !menuOpen);
-        
-        if (!gameOver && !menuOpen) {
-            SpawnNewItems();
-        }
-
-        // Draw Particles
-        for (int index = (signed) particles.size() - 1; index > -1; index--) {
-            particles[index]->Draw(cam);
-            if (particles[index]->isDead) {
-                free(particles[index]);
-                particles.erase(particles.begin() + index);
-            }
-        }
+        if (InShaderMode()) post.Prepare(game.selectedEffects, canvas);
+    }
 
-        // Draw Tractor
-        BeginMode2D(cam);
-            trac.color = game.colors[game.selectedColor];
-            trac.Draw(cam, !menuOpen);
-        EndMode2D();
+    // With the canvas the shader runs on its blit, so the frame doesn't need a full size target
+    BeginScreen(InShaderMode() && !lowResCanvas);
+    
+        ClearBackground(BLACK);
 
-        trac.DrawParticles(cam, !menuOpen);
-        
-        // Draw Explosion Particles
-        for (int index = (signed) explosionParticles.size() - 1; index > -1; index--) {
-            explosionParticles[index]->Draw(cam);
-            if (explosionParticles[index]->isDead) {
-                free(explosionParticles[index]);
-                explosionParticles.erase(explosionParticles.begin() + index);
-            }
-        }
+        if (lowResCanvas)
+            DrawCanvas();
+        else
+            DrawWorld(cam, alpha);
 
         // UI
         Rectangle heartStartDest = {16, 12, 48, 48};
-        Texture2D itemsTexture = GetTexture(Textures::items);
+        Texture2D &itemsTexture = GetTexture(spriteHandles.items);
         
         for (int index = 0; index < game.healthUpgrade.values[game.healthUpgrade.unlocked]; index++) {
             if (!((index + 1) % 2)) {
                 int id = index < currentHealth ? heartFullId : (index == currentHealth ? heartHalfFullId : heartEmptyId);
-                DrawTexturePro(itemsTexture, GetSourceRect(id, {(float) itemsTexture.width, (float) itemsTexture.height}, 16, 16), 
-                {heartStartDest.x + index / 2 * heartStartDest.width , heartStartDest.y, heartStartDest.width, heartStartDest.height}, {0, 0}, 0, WHITE);
+                batch.Draw(HudLayer, itemsTexture, GetSourceRect(Textures::items, id, 16, 16), 
+                {heartStartDest.x + index / 2 * heartStartDest.width , heartStartDest.y, heartStartDest.width, heartStartDest.height}, WHITE);
             } else if (index == game.healthUpgrade.values[game.healthUpgrade.unlocked] - 1) {
-                DrawTexturePro(itemsTexture, GetSourceRect(currentHealth == game.healthUpgrade.values[game.healthUpgrade.unlocked] ? heartHalfFullId : heartEmptyId, {(float) itemsTexture.width, (float) itemsTexture.height}, 16, 16), 
-                {heartStartDest.x + index / 2 * heartStartDest.width, heartStartDest.y, heartStartDest.width, heartStartDest.height}, {0, 0}, 0, WHITE);
+                batch.Draw(HudLayer, itemsTexture, GetSourceRect(Textures::items, currentHealth == game.healthUpgrade.values[game.healthUpgrade.unlocked] ? heartHalfFullId : heartEmptyId, 16, 16), 
+                {heartStartDest.x + index / 2 * heartStartDest.width, heartStartDest.y, heartStartDest.width, heartStartDest.height}, WHITE);
             }
         }
 
-        DrawCoins(Vector2 {16, 64}, game.inGameCoins, !menuOpen);
+        DrawCoins(Vector2 {16, 64}, game.inGameCoins, &batch);
         
         if (menuOpen || menuInAnim) {
+            batch.Flush();
             UpdateMenu();
         } else {
             Rectangle pauseButtonDest = {(float) GetScreenWidth() - 16 - 56, 16, 56, 56};
-            DrawTexturePro(GetTexture(Textures::pauseButtons), {0, 0, 8, 8}, pauseButtonDest, {0, 0}, 0, WHITE);
-            DrawTexturePro(GetTexture(Textures::pauseButtons), {0, 8, 8, 8}, pauseButtonDest, {0, 0}, 0, ColorAlpha(WHITE, (float) pauseBtnTimer / 10));
+            batch.Draw(HudLayer, GetTexture(spriteHandles.pauseButtons), GetSourceRect(Textures::pauseButtons, {0, 0, 8, 8}), pauseButtonDest, WHITE);
+            batch.Draw(HudLayer, GetTexture(spriteHandles.pauseButtons), GetSourceRect(Textures::pauseButtons, {0, 8, 8, 8}), pauseButtonDest, ColorAlpha(WHITE, (float) pauseBtnTimer / 10));
+            batch.Flush();
 
             if (CheckCollisionPointRec(GetMousePosition(), pauseButtonDest)) {
                 pauseBtnTimer = max((float) pauseBtnTimer + 1, 10);
@@ -285,17 +415,68 @@ void UpdateGame() {
             }
         }
 
-        UpdateTransitions();
-        UpdateEffects();
+        DrawTransitions();
+        if (showStats) DrawStats();
 
-    if (InShaderMode()) EndTextureMode(); else EndDrawing();
+    EndScreen();
+}
 
-    if (gameOver && isTransitionFinished("fade-gameover")) {
-        appState = ApplicationStates::GameOver;
-        InitGameOverScreen();
+void DrawWorld(Camera2D worldCam, float alpha) {
+    Texture2D &mapTexture = GetTexture(game.selectedMap);
+    Rectangle screen = {0, 0, GetScreenWidth() / cam.zoom * worldCam.zoom, GetScreenHeight() / cam.zoom * worldCam.zoom};
+    batch.Draw(BackgroundLayer, mapTexture, {0, 0, (float) mapTexture.width, (float) mapTexture.height}, screen, WHITE);
+
+    DrawItems(worldCam, alpha);
+
+    // Draw Particles
+    for (ScoreParticle &particle : particles) {
+        particle.Draw(batch, worldCam, alpha);
+    }
+
+    // Draw Tractor
+    trac.color = game.colors[game.selectedColor];
+    trac.Draw(batch, worldCam, alpha);
+    trac.DrawParticles(batch, worldCam, alpha);
+    
+    // Draw Explosion Particles
+    for (ExplosionParticle &particle : explosionParticles) {
+        particle.Draw(batch, worldCam);
     }
 }
 
+// Largest whole multiple of the canvas that fits the window, centred, so every texel stays square
+void DrawCanvas() {
+    float width = (float) canvas.texture.width;
+    float height = (float) canvas.texture.height;
+    int scale = (int) std::min(GetScreenWidth() / width, GetScreenHeight() / height);
+    if (scale < 1) scale = 1;
+
+    Rectangle dest = {(GetScreenWidth() - width * scale) / 2, (GetScreenHeight() - height * scale) / 2, width * scale, height * scale};
+    if (InShaderMode())
+        post.Draw(dest);
+    else
+        DrawTexturePro(canvas.texture, {0, 0, width, -height}, dest, {0, 0}, 0, WHITE);
+}
+
+void ResizeCanvas() {
+    int width = (int) (GetScreenWidth() / cam.zoom);
+    int height = (int) (GetScreenHeight() / cam.zoom);
+    if (canvas.texture.width == width && canvas.texture.height == height) return;
+
+    if (canvas.id != 0) UnloadRenderTexture(canvas);
+    canvas = LoadRenderTexture(width, height);
+}
+
+// Starts the frame on the window, or on target when the shader has to run over all of it
+void BeginScreen(bool shaded) {
+    frameInTarget = shaded;
+    if (shaded) BeginTextureMode(target); else BeginDrawing();
+}
+
+void EndScreen() {
+    if (frameInTarget) EndTextureMode(); else EndDrawing();
+}
+
 void UpdateEffects() {
     trac.isLongWagon = false;
     trac.isRainbow = false;
@@ -331,146 +512,115 @@ void UpdateEffects() {
     }
 }
 
-void UpdateItems(bool countCoins, bool moveItems) {
+void StepItems(bool countCoins) {
     Rectangle cartRect = trac.GetCartRect();
-    Texture2D itemsTexture = GetTexture(Textures::items);
+    fallingItems.Step(ItemStepInfo {cartRect, groundStartY, initialItemVel, inMagnetMode}, itemEvents);
 
-    for (int index = fallingItems.size() - 1; index > -1; index--) {
-        FallingItem &item = fallingItems[index];
-        float gravity = min(item.initalYVel / 26, 0.03);
-        unsigned char opacity = 255;
+    if (countCoins) {
+        for (int index : itemEvents.hitGround) {
+            OnHitGround(fallingItems.ids[index], fallingItems.GetPos(index), cartRect);
+        }
+        for (int index : itemEvents.landedInCart) {
+            OnInCart(fallingItems.ids[index], fallingItems.GetPos(index), cartRect);
+        }
+    }
 
-        if (moveItems) {
-            if (item.insideCart) {
-                item.pos.y += item.yVel;
-                if (item.pos.x < cartRect.x) item.pos.x = cartRect.x;
-                if (item.pos.x + itemTileSize >= cartRect.x + cartRect.width) item.pos.x = (cartRect.x + cartRect.width) - itemTileSize - 1;
-
-                Rectangle dest = {item.pos.x, item.pos.y - itemTileSize, itemTileSize, itemTileSize};
-                Rectangle source = GetSourceRect(item.id, {(float) itemsTexture.width, (float) itemsTexture.height}, tileWidth, tileHeight);
-                if (cartRect.y + cartRect.height < dest.y + dest.height) {
-                    source.height = dest.height = (cartRect.y + cartRect.height) - dest.y;
-                    if (source.height <= 0) {
-                        fallingItems.erase(fallingItems.begin() + index);
-                        continue;
-                    }
-                }
+    fallingItems.RemoveAll(itemEvents.removed);
+}
 
-                DrawTexturePro(itemsTexture, source, toScreenPos(dest, cam), {0, 0}, 0, Color {255, 255, 255, opacity});
-                continue;
-            }
+void DrawItems(Camera2D worldCam, float alpha) {
+    Rectangle cartRect = trac.GetCartRect();
+    Texture2D &itemsTexture = GetTexture(spriteHandles.items);
 
-            if (item.pos.y >= groundStartY) {
-                item.pos.y = groundStartY;
-                
-                if (!item.hasHitGround) {
-                    item.yVel = -(item.yVel / 4 > initialItemVel ? item.yVel / 4 : initialItemVel);
-                    item.hasHitGround = true;
-                    
-                    if (countCoins)
-                        OnHitGround(item, cartRect);
-            
-                } else {
-                    item.yVel = -item.yVel + gravity * 10;
-                }
+    for (int index = fallingItems.Size() - 1; index > -1; index--) {
+        Vector2 pos = fallingItems.GetDrawPos(index, alpha);
+        Rectangle dest = {pos.x, pos.y - itemTileSize, itemTileSize, itemTileSize};
+        Rectangle source = GetSourceRect(Textures::items, fallingItems.ids[index], tileWidth, tileHeight);
+        unsigned char opacity = 255;
 
-                if (std::abs(item.yVel) < gravity) {
-                    item.yVel = 0;
-                }
+        if (fallingItems.insideCart[index]) {
+            if (cartRect.y + cartRect.height < dest.y + dest.height) {
+                source.height = dest.height = (cartRect.y + cartRect.height) - dest.y;
+                if (source.height <= 0) continue;
             }
+        } else if (fallingItems.lifetimes[index] > itemLifetime - itemFadeTime) {
+            opacity = 255 - (255 / itemFadeTime) * (fallingItems.lifetimes[index] - (itemLifetime - itemFadeTime));
+        }
 
-            if (item.yVel != 0) {
-                item.pos.y += item.yVel; 
-
-                if (item.yVel > gravity && item.yVel < 0) {
-                    item.yVel = 0;
-                } else if (item.yVel < item.initalYVel) {
-                    item.yVel += gravity;
-                }
-
-
-                if (!item.hasHitGround) {
-                    Rectangle collisionRect = Rectangle {item.pos.x + 1, item.pos.y - itemTileSize, itemTileSize - 2, itemTileSize};
-
-                    item.pos.x += item.xVel;
-                    float difference = (item.pos.x + itemTileSize / 2) - (cartRect.x + cartRect.width / 2);
-                    if (std::abs(difference) <= 2 && !inMagnetMode)
-                        item.xVel = Diminish(item.xVel, 0.01);
-                    else
-                        item.xVel = Diminish(item.xVel, 0.005);
+        batch.Draw(ItemLayer, itemsTexture, source, toScreenPos(dest, worldCam), Color {255, 255, 255, opacity});
+    }
+}
 
-                    if (inMagnetMode) {
-                        if (difference < 2) {
-                            item.xVel = max(item.xVel + 0.015, 0.6);
-                        } else if (difference > 2) {
-                            item.xVel = min(item.xVel - 0.015, -0.6);
-                        }
-                    }
+void StepParticles() {
+    for (int index = particles.Size() - 1; index > -1; index--) {
+        ScoreParticle &particle = particles[index];
+        particle.prevPos = particle.pos;
+        particle.Update();
+        if (particle.isDead) particles.Remove(index);
+    }
 
-                    if (!CheckCollisionRecs({collisionRect.x, collisionRect.y - item.yVel, collisionRect.width, collisionRect.height}, cartRect)) {
-                        if (CheckCollisionRecs(collisionRect, cartRect)) {
-                            if (cartRect.x <= collisionRect.x && collisionRect.x + collisionRect.width < cartRect.x + cartRect.width) {
-                                item.insideCart = true;
+    for (int index = explosionParticles.Size() - 1; index > -1; index--) {
+        explosionParticles[index].Update();
+        if (explosionParticles[index].isDead) explosionParticles.Remove(index);
+    }
+}
 
-                                if (countCoins)
-                                    OnInCart(item, cartRect);
+// Toggled with F3, shows the sprite batch totals of the last frame
+void DrawStats() {
+    BatchStats &stats = batch.stats;
+    const char *text = TextFormat("%i fps\n%i sprites\n%i draw calls\n%i texture binds\n%i/%i score particles", 
+        GetFPS(), stats.sprites, stats.drawCalls, stats.textureBinds, particles.Size(), particles.GetCapacity());
+    DrawText(text, 16, GetScreenHeight() - 136, 20, WHITE);
+}
 
-                            } else {
-                                item.yVel = -item.yVel;
-                            }
-                        }
-                    }
-                }
+void PrintPoolStats() {
+    print("Score particles peak " << particles.HighWaterMark() << "/" << particles.GetCapacity() << ", dropped " << particles.Dropped());
+    print("Explosion particles peak " << explosionParticles.HighWaterMark() << "/" << explosionParticles.GetCapacity() << ", dropped " << explosionParticles.Dropped());
+}
 
-            } else {
-                item.pos.x = std::floor(item.pos.x);
-                item.pos.y = std::floor(item.pos.y);
-
-                item.lifetime++;
-                if (item.lifetime > 3600) {
-                    fallingItems.erase(fallingItems.begin() + index);
-                    continue;
-                } else if (item.lifetime > 3600 - 60) {
-                    opacity = 255 - (255 / 60) * (item.lifetime - (3600 - 60));
-                }
-            }
-        }
+// Compiled is the cold cost of the effects used this session, cached is what a warm launch paid instead
+void PrintShaderStats() {
+    ShaderCacheStats &stats = post.Stats();
+    print("Shaders compiled " << stats.compiled << " in " << stats.compileTime * 1000 << " ms, loaded from cache " << stats.cached << " in " << stats.cacheTime * 1000 << " ms");
+}
 
-        Rectangle dest = toScreenPos(Rectangle {item.pos.x, item.pos.y - itemTileSize, itemTileSize, itemTileSize}, cam);
-        DrawTexturePro(itemsTexture, GetSourceRect(item.id, {(float) itemsTexture.width, (float) itemsTexture.height}, tileWidth, tileHeight), dest, {0, 0}, 0, Color {255, 255, 255, opacity});
+void PlayTickSounds() {
+    for (Sounds sound : tickSounds) {
+        PlaySound(GetSound(sound));
     }
+    tickSounds.clear();
 }
 
-void OnInCart(FallingItem &item, Rectangle cartRect) {
-    int amount = GetPointValueFromId(item.id, false);
+void OnInCart(int id, Vector2 pos, Rectangle cartRect) {
+    int amount = GetPointValueFromId(id, false);
 
     if ((inLightningMode && amount > 0) || !inLightningMode) {
         game.inGameCoins += amount;
     }
     
-    if (item.id == heartId) {
+    if (id == heartId) {
         if (currentHealth == game.healthUpgrade.values[game.healthUpgrade.unlocked]) {
-            particles.push_back(new ScoreParticle(amount, Vector2 {item.pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, false));
+            particles.Spawn(ScoreParticle(amount, Vector2 {pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, false));
         } else {
             currentHealth += 2;
-            particles.push_back(new ScoreParticle(2, Vector2 {item.pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, true));
+            particles.Spawn(ScoreParticle(2, Vector2 {pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, true));
             if (currentHealth > game.healthUpgrade.values[game.healthUpgrade.unlocked]) 
                 currentHealth = game.healthUpgrade.values[game.healthUpgrade.unlocked];
         }
-    } else if (item.id == longWagonId) {
+    } else if (id == longWagonId) {
         effects.push_back(Effect {EffectType::LongWagon, 1600});
         if (trac.isLongWagon)
-            PlaySound(GetSound(Sounds::ExtraLongWagonVoice));
+            tickSounds.push_back(Sounds::ExtraLongWagonVoice);
         else
-            PlaySound(GetSound(Sounds::LongWagonVoice));
-    } else if (item.id == lightningId) {
+            tickSounds.push_back(Sounds::LongWagonVoice);
+    } else if (id == lightningId) {
         effects.push_back(Effect {EffectType::Lightning, 900});
-        PlaySound(GetSound(Sounds::SpeedVoice));
-    } else if (item.id == magnetId) {
+        tickSounds.push_back(Sounds::SpeedVoice);
+    } else if (id == magnetId) {
         effects.push_back(Effect {EffectType::Magnet, 1600});
-        PlaySound(GetSound(Sounds::MagnetVoice));
+        tickSounds.push_back(Sounds::MagnetVoice);
     } else {
-        particles.push_back(new ScoreParticle(amount, Vector2 {item.pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, false));
+        particles.Spawn(ScoreParticle(amount, Vector2 {pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, false));
     }
 
     if (amount < 0 && !inLightningMode) {
@@ -478,9 +628,9 @@ void OnInCart(FallingItem &item, Rectangle cartRect) {
         if (currentHealth < 0) 
             currentHealth = 0;
         
-        if (item.id == bombId || item.id == dynomiteId) {
-            PlaySound(GetSound(Sounds::BoomVoice));
-            explosionParticles.push_back(new ExplosionParticle({item.pos.x + itemTileSize / 2, cartRect.y - itemTileSize / 2}));
+        if (id == bombId || id == dynomiteId) {
+            tickSounds.push_back(Sounds::BoomVoice);
+            explosionParticles.Spawn(ExplosionParticle({pos.x + itemTileSize / 2, cartRect.y - itemTileSize / 2}));
         }
     }
 
@@ -488,11 +638,11 @@ void OnInCart(FallingItem &item, Rectangle cartRect) {
         game.inGameCoins = 0;
 }
 
-void OnHitGround(FallingItem &item, Rectangle cartRect) {
-    int amount = GetPointValueFromId(item.id, true);
+void OnHitGround(int id, Vector2 pos, Rectangle cartRect) {
+    int amount = GetPointValueFromId(id, true);
     game.inGameCoins += amount;
 
-    if (amount != 0) particles.push_back(new ScoreParticle(amount, Vector2 {item.pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, false));
+    if (amount != 0) particles.Spawn(ScoreParticle(amount, Vector2 {pos.x + itemTileSize / 2, cartRect.y - itemTileSize}, false));
 
     if (amount < 0) {
         currentHealth -= 1;
@@ -527,8 +677,8 @@ void SpawnNewItems() {
             id = heartId;
 
         // Check if id is the same
-        if (fallingItems.size() > 0) {
-            if (fallingItems[-1].id == id) {
+        if (!fallingItems.Empty()) {
+            if (fallingItems.ids.back() == id) {
                 if (GetRandomValue(0, 3) != 0) {
                     nextItemTime = 0;
                     return;
@@ -537,7 +687,7 @@ void SpawnNewItems() {
         }
         
         float x = (float) GetRandomValue(itemTileSize / 2, (sw - itemTileSize - itemTileSize / 2));
-        if (fallingItems.size() > 0) {
+        if (!fallingItems.Empty()) {
             int cartCenter = trac.GetCartRect().x + trac.GetCartRect().width / 2;
             if (nextItemDuration < 20)
                 x = max(min(GetRandomValue(cartCenter - 16, cartCenter + 16), 0), (sw - itemTileSize - itemTileSize / 2));
@@ -548,10 +698,7 @@ void SpawnNewItems() {
         }
 
 
-        fallingItems.push_back(FallingItem {
-            Vector2 {x, 0}, 
-            id, velocity
-        });
+        fallingItems.Add(Vector2 {x, 0}, id, velocity);
 
         if (!GetRandomValue(0, 4))
             nextItemDuration = GetRandomValue(60, 100);
@@ -612,7 +759,7 @@ float GetVelFromCoins(int coins) {
 }
 
 bool InShaderMode() {
-    return game.selectedShader != Shaders::None;
+    return game.selectedEffects != 0 && gameAssetsReady;
 }
 
 /* ----------- Title Screen ----------- */
@@ -623,52 +770,61 @@ void InitTitleScreen() {
     titleArrowAnim.reset();
     
     nextItemTime = 0;
-    fallingItems.clear();
+    fallingItems.Clear();
     for (int index = GetRandomValue(3, 5); index > 0; index--) {
         SpawnTitleScreenItems(true);
     }
 }
 
-void UpdateTitleScreen() {
+void StepTitleScreen() {
+    coinAnimation.Update();
+    if (isShopOpen()) return;
+
+    fallingItems.StorePrevious();
+    for (int index = fallingItems.Size() - 1; index > -1; index--) {
+        fallingItems.y[index] += fallingItems.yVel[index];
+
+        if (fallingItems.hitGround[index]) {
+            fallingItems.yVel[index] = max(fallingItems.yVel[index] + 0.3, 8);
+        }
+        if (fallingItems.y[index] > GetScreenHeight()) {
+            fallingItems.Remove(index);
+        }
+    }
+
+    nextItemTime--;
+    if (nextItemTime <= 0) SpawnTitleScreenItems(false);
+}
+
+void UpdateTitleScreen(float alpha) {
     JakeFont &font = GetFont(Fonts::normal);
-    if (InShaderMode()) BeginTextureMode(target); else BeginDrawing();
+    BeginScreen(InShaderMode());
         ClearBackground(BLACK);
 
         Texture2D &titleScreenBgText1 = GetTexture(Textures::titleScreenBg1);
         DrawTexturePro(titleScreenBgText1, {0, 0, (float) titleScreenBgText1.width, (float) titleScreenBgText1.height}, {0, 0, (float) GetScreenWidth(), (float) GetScreenHeight()}, {0, 0}, 0, WHITE);
 
         if (!isShopOpen()) {
-            Texture2D &itemsTexture = GetTexture(Textures::items);
-            for (int index = (signed) fallingItems.size() - 1; index > -1; index--) {
-                FallingItem &item = fallingItems[index];
-                Rectangle source = GetSourceRect(item.id, {(float) itemsTexture.width, (float) itemsTexture.height}, tileWidth, tileHeight);
-                Rectangle dest = {item.pos.x, item.pos.y, tileWidth * 4, tileHeight * 4};
+            Texture2D &itemsTexture = GetTexture(spriteHandles.items);
+            for (int index = fallingItems.Size() - 1; index > -1; index--) {
+                Vector2 pos = fallingItems.GetDrawPos(index, alpha);
+                Rectangle source = GetSourceRect(Textures::items, fallingItems.ids[index], tileWidth, tileHeight);
+                Rectangle dest = {pos.x, pos.y, tileWidth * 4, tileHeight * 4};
                 DrawTexturePro(itemsTexture, source, dest, {0, 0}, 0, WHITE);
 
-                item.pos.y += item.yVel;
-
-                if (item.hasHitGround) {
-                    item.yVel = max(item.yVel + 0.3, 8);
-                }
-                if (item.pos.y > GetScreenHeight()) {
-                    fallingItems.erase(fallingItems.begin() + index);
-                }
                 if (CheckCollisionPointRec(GetMousePosition(), dest) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    item.hasHitGround = true;
-                    item.yVel = -5;
+                    fallingItems.hitGround[index] = true;
+                    fallingItems.yVel[index] = -5;
                 }
             }
-
-            nextItemTime--;
-            if (nextItemTime <= 0) SpawnTitleScreenItems(false);
         }
 
         Texture2D titleScreenBgText2 = GetTexture(Textures::titleScreenBg2);
         DrawTexturePro(titleScreenBgText2, {0, 0, (float) titleScreenBgText2.width, (float) titleScreenBgText2.height}, {0, 0, (float) GetScreenWidth(), (float) GetScreenHeight()}, {0, 0}, 0, WHITE);
         
-        Texture2D &titleTexture = GetTexture(Textures::title);
-        DrawTexturePro(titleTexture, {0, 0, (float) titleTexture.width, (float) titleTexture.height}, 
-            {(float) GetScreenWidth() / 2 - titleTexture.width * 5 / 2, 85, (float) titleTexture.width * 5, (float) titleTexture.height * 5}, {0, 0}, 0, WHITE);
+        Rectangle titleRect = GetTextureRect(Textures::title);
+        DrawTexturePro(GetTexture(Textures::title), titleRect, 
+            {(float) GetScreenWidth() / 2 - titleRect.width * 5 / 2, 85, (float) titleRect.width * 5, (float) titleRect.height * 5}, {0, 0}, 0, WHITE);
 
         float startY = (float) GetScreenHeight() / 2 + 24;
         int optionFontSize = 7;
@@ -715,17 +871,20 @@ void UpdateTitleScreen() {
             titleArrowAnim.decrement();
         else if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
             if (titleHoveredIndex == 0)  {
+                FinishLoadingAssets();
                 appState = ApplicationStates::Running;
                 transitions.push_back(new BoxTransition("title-screen-to-game", 40, true));
                 InitGame();
             } else if (titleHoveredIndex == 1) {
+                // The background panel previews the maps
+                FinishLoadingAssets();
                 setShopStatus(true);
             }
         }
 
-        UpdateTransitions();
+        DrawTransitions();
 
-    if (InShaderMode()) EndTextureMode(); else EndDrawing();
+    EndScreen();
 }
 
 void SpawnTitleScreenItems(bool randomY) {
@@ -736,8 +895,8 @@ void SpawnTitleScreenItems(bool randomY) {
         pos = Vector2 {(float) GetRandomValue(128, GetScreenWidth() - 192), (float) (!randomY ? -64 : GetRandomValue(0, GetScreenHeight() - 64))};
 
         bool isAllowed = true;
-        for (FallingItem &item : fallingItems) {
-            if (Distance(item.pos, pos) < 350) {
+        for (int index = 0; index < fallingItems.Size(); index++) {
+            if (Distance(fallingItems.GetPos(index), pos) < 350) {
                 isAllowed = false;
                 break;
             }
@@ -748,13 +907,13 @@ void SpawnTitleScreenItems(bool randomY) {
         int id;
         while (true) {
             id = GetRandomValue(fruitIds.x, fruitIds.y);
-            if (fallingItems.size() > 0) {
-                if (fallingItems[-1].id == id) continue; 
+            if (!fallingItems.Empty()) {
+                if (fallingItems.ids.back() == id) continue; 
             }
             break;
         }
 
-        fallingItems.push_back(FallingItem {pos, id, 3});
+        fallingItems.Add(pos, id, 3);
         return;
     }
 
@@ -770,6 +929,27 @@ void InitGameOverScreen() {
     EndGame();
 }
 
+void StepGameOverScreen() {
+    gameOverAnimTimer++;
+    coinAnimation.Update();
+
+    if (gameOverAnimTimer > 90) {
+        if (playAgainColor.a < 255 - 30) {
+            playAgainColor.a += 30;  
+        } else {
+            playAgainColor.a = 255;  
+        }
+
+        if (gameOverCoins < game.coins && gameOverAnimTimer > 95) {
+            coinShaketimer = 10;
+            gameOverCoins += 7;
+        }
+
+        if (coinShaketimer)
+            coinShaketimer--;
+    }
+}
+
 void UpdateGameOverScreen() {
     JakeFont &font = GetFont(Fonts::normal);
 
@@ -785,7 +965,7 @@ void UpdateGameOverScreen() {
     int playAgainWidth = font.Measure(playAgainText) * playAgainSize;
     Vector2 playAgainPos = {(float) (GetScreenWidth() - playAgainWidth) / 2, (float) GetScreenHeight() / 2};
 
-    if (InShaderMode()) BeginTextureMode(target); else BeginDrawing();
+    BeginScreen(InShaderMode());
         DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), negativeColor);
 
         int animationIndex = 0;        
@@ -801,23 +981,17 @@ void UpdateGameOverScreen() {
         }
 
         if (gameOverAnimTimer > 90) {
-            if (playAgainColor.a < 255 - 30) {
-                playAgainColor.a += 30;  
-            } else {
-                playAgainColor.a = 255;  
-            }
-
             std::string playAgainText = "Play Again";
             font.Render("Play Again", playAgainPos, playAgainSize, playAgainColor);
 
-            if (CheckCollisionPointRec(GetMousePosition(), {playAgainPos.x, playAgainPos.y, (float) playAgainWidth, (float) font.texture.height * playAgainSize})) {
+            if (CheckCollisionPointRec(GetMousePosition(), {playAgainPos.x, playAgainPos.y, (float) playAgainWidth, (float) font.height * playAgainSize})) {
                 if (playAgainColor.r < 255) {
                     playAgainColor.r += 5; playAgainColor.g += 5; playAgainColor.b += 5;
                     if (playAgainColor.r > 255) {
                         playAgainColor.r = 255; playAgainColor.g = 255; playAgainColor.b = 255;
                     }
                 }
-                DrawRectangle(playAgainPos.x, playAgainPos.y + font.texture.height * playAgainSize + playAgainSize, playAgainWidth, playAgainSize, playAgainColor);
+                DrawRectangle(playAgainPos.x, playAgainPos.y + font.height * playAgainSize + playAgainSize, playAgainWidth, playAgainSize, playAgainColor);
                 if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
                     transitions.push_back(new BoxTransition("game-over-to-title-screen", 40, true));
                     appState = ApplicationStates::TitleScreen;
@@ -833,26 +1007,18 @@ void UpdateGameOverScreen() {
                 }
             }
 
-            if (gameOverCoins < game.coins && gameOverAnimTimer > 95) {
-                coinShaketimer = 10;
-                gameOverCoins += 7;
-            }
-
             Vector2 coinPos = {16, 16};
             if (coinShaketimer) {
                 coinPos.y -= GetRandomValue(-1, 1) * 4;
                 coinPos.x -= GetRandomValue(-1, 1) * 4;
             }
-            if (coinShaketimer)
-                coinShaketimer--;
 
             DrawCoins(coinPos, gameOverCoins);
         }
 
-        gameOverAnimTimer++;
-        UpdateTransitions();
+        DrawTransitions();
 
-    if (InShaderMode()) EndTextureMode(); else EndDrawing();
+    EndScreen();
 }
 
 /* --------------- Menu --------------- */
@@ -884,8 +1050,8 @@ void UpdateMenu() {
         sourceX = 24;
 
     Rectangle pauseButtonDest = {(float) GetScreenWidth() - 16 - 56, 16, 56, 56};
-    DrawTexturePro(GetTexture(Textures::pauseButtons), {(float) sourceX, 0, 8, 8}, pauseButtonDest, {0, 0}, 0, WHITE);
-    DrawTexturePro(GetTexture(Textures::pauseButtons), {(float) sourceX, 8, 8, 8}, pauseButtonDest, {0, 0}, 0, ColorAlpha(WHITE, (float) pauseBtnTimer / 10));
+    DrawTexturePro(GetTexture(spriteHandles.pauseButtons), GetSourceRect(Textures::pauseButtons, {(float) sourceX, 0, 8, 8}), pauseButtonDest, {0, 0}, 0, WHITE);
+    DrawTexturePro(GetTexture(spriteHandles.pauseButtons), GetSourceRect(Textures::pauseButtons, {(float) sourceX, 8, 8, 8}), pauseButtonDest, {0, 0}, 0, ColorAlpha(WHITE, (float) pauseBtnTimer / 10));
 
     if (CheckCollisionPointRec(GetMousePosition(), pauseButtonDest) && !isShopOpen()) {
         pauseBtnTimer = max((float) pauseBtnTimer + 1, 10);
@@ -978,76 +1144,111 @@ void UpdateMenu() {
 
 /* ------------- Functions ------------ */
 
-void DrawCoins(Vector2 startPos, int numOfCoins, bool updateAnimation) {
-    if (updateAnimation)
-        coinAnimation.Update();
-    
+void DrawCoins(Vector2 startPos, int numOfCoins, SpriteBatch *batch) {
     std::string text = std::string("Coins: ") + std::to_string(numOfCoins);
-    DrawTexturePro(GetTexture(Textures::coinsheet), {(float) coinAnimation.Get() * 16, 0, 16, 16}, {startPos.x, startPos.y, 48, 48}, {0, 0}, 0, WHITE);
-    GetFont(Fonts::normal).Render(text, {startPos.x + 58, startPos.y}, 4, Color {248, 183, 57, 255});
+    Rectangle source = GetSourceRect(Textures::coinsheet, {(float) coinAnimation.Get() * 16, 0, 16, 16});
+    Rectangle dest = {startPos.x, startPos.y, 48, 48};
+
+    if (batch)
+        batch->Draw(HudLayer, GetTexture(spriteHandles.coinsheet), source, dest, WHITE);
+    else
+        DrawTexturePro(GetTexture(spriteHandles.coinsheet), source, dest, {0, 0}, 0, WHITE);
+    GetFont(Fonts::normal).Render(text, {startPos.x + 58, startPos.y}, 4, Color {248, 183, 57, 255}, batch);
 }
 
-void UpdateTransitions() {
+void StepTransitions() {
     for (int index = (signed) transitions.size() - 1; index > -1; index--) {
         if (transitions[index]->isFinished) {
-            free(transitions[index]);
+            delete transitions[index];
             transitions.erase(transitions.begin() + index);
         } else {
+            transitions[index]->Update();
+        }
+    }
+}
+
+void DrawTransitions() {
+    for (int index = (signed) transitions.size() - 1; index > -1; index--) {
+        if (!transitions[index]->isFinished) {
             transitions[index]->Draw();
         }
     }
 }
 
 void UpdateScreenSize() {
+    if (!IsWindowReady()) return;
     sh = GetScreenHeight() / cam.zoom;
     sw = GetScreenWidth() / cam.zoom;
 }
 
-void SetNextShader(Shaders shader) {
-    nextShader = shader;
+void SetNextEffects(EffectSet effects) {
+    nextEffects = effects;
+}
+
+void WarmEffects(EffectSet effects) {
+    post.Warm(effects);
 }
 
 GameData &GetGameData() {
     return game;
 }
 
-/* -------------- Classes ------------- */
+RunState GetRunState() {
+    Rectangle cartRect = trac.GetCartRect();
+    return RunState {gameTime, currentHealth, game.inGameCoins, fallingItems.Size(), trac.rect.x + trac.rect.width / 2,
+        cartRect.x + cartRect.width / 2, gameOver};
+}
 
-void ExplosionParticle::Draw(Camera2D cam) {
-    int frameDuration = 5;
-    Texture2D &explosionTexture = GetTexture(Textures::explosion);
-    
-    Vector2 relativeCenter = toScreenPos(center, cam);
-    DrawTexturePro(explosionTexture, {(float) 45 * (timer / frameDuration), 0, 45, 45}, 
-        {relativeCenter.x - (45 / 2) * cam.zoom, relativeCenter.y - (45 / 2) * cam.zoom, 45 * cam.zoom, 45 * cam.zoom}, {0, 0}, 0, WHITE);
+ItemStore &GetFallingItems() {
+    return fallingItems;
+}
+
+std::vector<Sounds> &GetTickSounds() {
+    return tickSounds;
+}
 
+/* -------------- Classes ------------- */
+
+void ExplosionParticle::Update() {
     timer += 1;
-    if (timer >= 7 * frameDuration)
+    if (timer >= 7 * explosionFrameDuration)
         isDead = true;
 }
 
+void ExplosionParticle::Draw(SpriteBatch &batch, Camera2D cam) {
+    Texture2D &explosionTexture = GetTexture(spriteHandles.explosion);
+    
+    Vector2 relativeCenter = toScreenPos(center, cam);
+    batch.Draw(ExplosionLayer, explosionTexture, GetSourceRect(Textures::explosion, {(float) 45 * (timer / explosionFrameDuration), 0, 45, 45}), 
+        {relativeCenter.x - (45 / 2) * cam.zoom, relativeCenter.y - (45 / 2) * cam.zoom, 45 * cam.zoom, 45 * cam.zoom}, WHITE);
+}
+
 ScoreParticle::ScoreParticle(int score, Vector2 position, bool isHp) {
     timer = 0;
     lifetime = 60;
     posative = score > 0;
-    text = posative ? (std::string("+") + std::to_string(score)) : std::to_string(score);
-    if (isHp) text += std::string(" hp"); 
+    snprintf(text, sizeof(text), posative ? "+%d%s" : "%d%s", score, isHp ? " hp" : "");
 
     pos = {position.x - GetFont(Fonts::normal).Measure(text) / 2, position.y};
+    prevPos = pos;
 }
 
-void ScoreParticle::Draw(Camera2D cam) {
+void ScoreParticle::Update() {
     timer++;
     pos.y -= 0.065;
-    Color color = posative ? positiveColor : negativeColor;
-    GetFont(Fonts::normal).Render(text, toScreenPos(Vector2 {pos.x - 0.5f, pos.y + 0.5f}, cam), cam.zoom, {0, 0, 0, 45});
-    GetFont(Fonts::normal).Render(text, toScreenPos(pos, cam), cam.zoom, color);
     
     if (timer > lifetime) {
         isDead = true;
     }
 }
 
+void ScoreParticle::Draw(SpriteBatch &batch, Camera2D cam, float alpha) {
+    Vector2 drawPos = Interpolate(prevPos, pos, alpha);
+    Color color = posative ? positiveColor : negativeColor;
+    GetFont(Fonts::normal).Render(text, toScreenPos(Vector2 {drawPos.x - 0.5f, drawPos.y + 0.5f}, cam), cam.zoom, {0, 0, 0, 45}, &batch, ScoreLayer);
+    GetFont(Fonts::normal).Render(text, toScreenPos(drawPos, cam), cam.zoom, color, &batch, ScoreLayer);
+}
+
 Transition::Transition(const char* _name, int _totalDuration, bool _isReversed) {
     timer = 0;
     name = _name;
@@ -1055,6 +1256,13 @@ Transition::Transition(const char* _name, int _totalDuration, bool _isReversed)
     isReversed = _isReversed;
 }
 
+void Transition::Update() {
+    timer++;
+    if (timer > totalDuration) {
+        isFinished = true;
+    }
+}
+
 void BoxTransition::Draw() {
     int maxHeight = GetScreenHeight() / 2;
     int height = max(((float) timer / (totalDuration - 10)) * maxHeight, maxHeight);
@@ -1062,11 +1270,6 @@ void BoxTransition::Draw() {
 
     DrawRectangle(0, 0, GetScreenWidth(), height, BLACK);
     DrawRectangle(0, GetScreenHeight() - height, GetScreenWidth(), height, BLACK);
-
-    timer++;
-    if (timer > totalDuration) {
-        isFinished = true;
-    }
 }
 
 FadeTransition::FadeTransition(const char* _name, int _totalDuration, Color _color, bool _isReversed) {
@@ -1081,11 +1284,6 @@ void FadeTransition::Draw() {
     int alpha = ((float) timer / totalDuration) * 255;
     if (isReversed) alpha = 255 - alpha;
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), Color {color.r, color.g, color.b, (unsigned char) alpha});
-
-    timer++;
-    if (timer > totalDuration) {
-        isFinished = true;
-    }
 }
 
 Animation::Animation(std::vector<int> frameVector, int frameDur, bool repeating) {
@@ -1140,7 +1338,7 @@ std::string GameData::toString() {
         + IntToBase(luckUpgrade.unlocked, totalChars) + "-"
         + IntToBase(selectedColor, totalChars) + "-"
         + IntToBase((int) selectedMap, totalChars) + "-"
-        + IntToBase((int) selectedShader, totalChars);
+        + IntToBase((int) selectedEffects, totalChars);
 
     stringRepresentation = EncryptString(stringRepresentation);
     stringRepresentation += chars[BaseToInt(stringRepresentation, totalChars) % totalChars];
@@ -1155,95 +1353,151 @@ void GameData::fromString(std::string) {
 /* ------------- Loading ------------- */
 
 void PreloadAssets() {
-    texturesToLoad[Textures::cart] = "resources/img/cart.png";
-    texturesToLoad[Textures::tiles] = "resources/img/tiles.png";
-    texturesToLoad[Textures::items] = "resources/img/items.png";
-    texturesToLoad[Textures::tractor] = "resources/img/tractor.png";
-    texturesToLoad[Textures::wheelLarge] = "resources/img/wheelLarge.png"; 
-    texturesToLoad[Textures::wheelSmall] = "resources/img/wheelSmall.png";
-    texturesToLoad[Textures::halo] = "resources/fx/halo.png";
-    texturesToLoad[Textures::smoke] = "resources/fx/smoke.png";
-    texturesToLoad[Textures::title] = "resources/img/title.png";
-    texturesToLoad[Textures::coinsheet] = "resources/img/coin.png";
-    texturesToLoad[Textures::normalFont] = "resources/img/normalFont.png";
-    texturesToLoad[Textures::titleScreenBg1] = "resources/img/titleScreenBg1.png";
-    texturesToLoad[Textures::titleScreenBg2] = "resources/img/titleScreenBg2.png";
-    texturesToLoad[Textures::explosion] = "resources/fx/explosion.png";
-    texturesToLoad[Textures::gui] = "resources/img/gui.png";
-    texturesToLoad[Textures::pauseButtons] = "resources/img/pauseButtons.png";
-    texturesToLoad[Textures::map1] = "resources/map/map1.png";
-    texturesToLoad[Textures::map2] = "resources/map/map2.png";
-    texturesToLoad[Textures::map3] = "resources/map/map3.png";
-
-    soundsToLoad[Sounds::LongWagonVoice] = "resources/sound/LongWagonVoice.mp3";
-    soundsToLoad[Sounds::ExtraLongWagonVoice] = "resources/sound/ExtraLongWagonVoice.mp3";
-    soundsToLoad[Sounds::BoomVoice] = "resources/sound/BoomVoice.mp3";
-    soundsToLoad[Sounds::MagnetVoice] = "resources/sound/MagnetVoice.mp3";
-    soundsToLoad[Sounds::SpeedVoice] = "resources/sound/SpeedVoice.mp3";
+    // Small sprite sheets are packed into the atlas, full screen images keep their own texture
+    QueueSprite(Textures::cart, "resources/img/cart.png");
+    QueueSprite(Textures::items, "resources/img/items.png");
+    QueueSprite(Textures::tractor, "resources/img/tractor.png");
+    QueueSprite(Textures::wheelLarge, "resources/img/wheelLarge.png");
+    QueueSprite(Textures::wheelSmall, "resources/img/wheelSmall.png");
+    QueueSprite(Textures::halo, "resources/fx/halo.png");
+    QueueSprite(Textures::smoke, "resources/fx/smoke.png");
+    QueueSprite(Textures::title, "resources/img/title.png");
+    QueueSprite(Textures::coinsheet, "resources/img/coin.png");
+    QueueSprite(Textures::normalFont, "resources/img/normalFont.png");
+    QueueSprite(Textures::explosion, "resources/fx/explosion.png");
+    QueueSprite(Textures::gui, "resources/img/gui.png");
+    QueueSprite(Textures::pauseButtons, "resources/img/pauseButtons.png");
+
+    QueueTexture(GameAssets, Textures::tiles, "resources/img/tiles.png");
+    QueueTexture(TitleAssets, Textures::titleScreenBg1, "resources/img/titleScreenBg1.png");
+    QueueTexture(TitleAssets, Textures::titleScreenBg2, "resources/img/titleScreenBg2.png");
+    QueueTexture(GameAssets, Textures::map1, "resources/map/map1.png");
+    QueueTexture(GameAssets, Textures::map2, "resources/map/map2.png");
+    QueueTexture(GameAssets, Textures::map3, "resources/map/map3.png");
+
+    QueueSound(TitleAssets, Sounds::LongWagonVoice, "resources/sound/LongWagonVoice.mp3");
+    QueueSound(TitleAssets, Sounds::ExtraLongWagonVoice, "resources/sound/ExtraLongWagonVoice.mp3");
+    QueueSound(GameAssets, Sounds::BoomVoice, "resources/sound/BoomVoice.mp3");
+    QueueSound(GameAssets, Sounds::MagnetVoice, "resources/sound/MagnetVoice.mp3");
+    QueueSound(GameAssets, Sounds::SpeedVoice, "resources/sound/SpeedVoice.mp3");
+
+    if (bundle.IsOpen()) loader.UseBundle(&bundle);
+    loader.Start();
+}
+
+void QueueTexture(AssetGroups group, Textures name, const char *path) {
+    loader.QueueImage(group, path, [name](Image image) {
+        Texture2D texture = LoadTextureFromImage(image);
+        loadedTextures.Set(name, texture);
+        textureRects[name] = Rectangle {0, 0, (float) texture.width, (float) texture.height};
+    });
+}
+
+void QueueSprite(Textures name, const char *path) {
+    // Every sheet has to be in the atlas before it is built, so they all belong to the title screen
+    loader.QueueImage(TitleAssets, path, [name](Image image) {
+        atlas.Add(name, image);
+    });
+}
+
+void QueueSound(AssetGroups group, Sounds name, const char *path) {
+    loader.QueueWave(group, path, [name](Wave wave) {
+        loadedSounds.Set(name, LoadSoundFromWave(wave));
+    });
 }
 
 void UnloadAssets() {
-    for (auto &[name, item] : loadedTextures) {
-        UnloadTexture(item);
-    }
-    for (auto &[name, item] : loadedSounds) {
-        UnloadSound(item);
+    // Packed sheets only hold a copy of their page, the atlas owns those
+    for (int index = 0; index < totalTextures; index++) {
+        Textures name = (Textures) index;
+        if (!loadedTextures.IsLoaded(name)) continue;
+        if (!atlas.Contains(name)) UnloadTexture(loadedTextures.Get(name));
+        loadedTextures.Unload(name);
     }
-    for (auto &[name, item] : loadedFonts) {
-        UnloadTexture(item.texture);
+    atlas.Unload();
+    for (int index = 0; index < totalSounds; index++) {
+        Sounds name = (Sounds) index;
+        if (!loadedSounds.IsLoaded(name)) continue;
+        UnloadSound(loadedSounds.Get(name));
+        loadedSounds.Unload(name);
     }
-    for (auto &[name, item] : shaders) {
-        UnloadShader(item);
+    for (int index = 0; index < totalFonts; index++) {
+        loadedFonts.Unload((Fonts) index);
     }
 }
 
 void LoadOther() {
-    loadedFonts[Fonts::normal] = JakeFont(GetTexture(Textures::normalFont), "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890!@#$%^&*()-=_+[]{}\\/;:,.<>?`~", 5 );
+    loadedFonts.Set(Fonts::normal, JakeFont(GetTexture(Textures::normalFont), GetTextureRect(Textures::normalFont), "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890!@#$%^&*()-=_+[]{}\\/;:,.<>?`~", 5 ));
     LoadShop();
 }
 
-void LoadShaders() {
-    shaders[FX_GRAYSCALE] = LoadShader(0, TextFormat("resources/shaders/glsl%i/grayscale.fs", GLSL_VERSION));
-    shaders[FX_POSTERIZATION] = LoadShader(0, TextFormat("resources/shaders/glsl%i/posterization.fs", GLSL_VERSION));
-    shaders[FX_DREAM_VISION] = LoadShader(0, TextFormat("resources/shaders/glsl%i/dream_vision.fs", GLSL_VERSION));
-    shaders[FX_PIXELIZER] = LoadShader(0, TextFormat("resources/shaders/glsl%i/pixelizer.fs", GLSL_VERSION));
-    shaders[FX_CROSS_HATCHING] = LoadShader(0, TextFormat("resources/shaders/glsl%i/cross_hatching.fs", GLSL_VERSION));
-    shaders[FX_CROSS_STITCHING] = LoadShader(0, TextFormat("resources/shaders/glsl%i/cross_stitching.fs", GLSL_VERSION));
-    shaders[FX_PREDATOR_VIEW] = LoadShader(0, TextFormat("resources/shaders/glsl%i/predator.fs", GLSL_VERSION));
-    shaders[FX_SCANLINES] = LoadShader(0, TextFormat("resources/shaders/glsl%i/scanlines.fs", GLSL_VERSION));
-    shaders[FX_FISHEYE] = LoadShader(0, TextFormat("resources/shaders/glsl%i/fisheye.fs", GLSL_VERSION));
-    shaders[FX_SOBEL] = LoadShader(0, TextFormat("resources/shaders/glsl%i/sobel.fs", GLSL_VERSION));
-    shaders[FX_BLOOM] = LoadShader(0, TextFormat("resources/shaders/glsl%i/bloom.fs", GLSL_VERSION));
-    shaders[FX_BLUR] = LoadShader(0, TextFormat("resources/shaders/glsl%i/blur.fs", GLSL_VERSION));
+// Uses the bundled copy when there is one, the loose file otherwise
+Image LoadBundledImage(const char *path) {
+    const BundleEntry *entry = bundle.IsOpen() ? bundle.Find(path) : nullptr;
+    if (!entry) return LoadImage(path);
+
+    return ImageCopy(Image {(void *) bundle.Data(entry), entry->width, entry->height, 1, (int) entry->format});
+}
+
+std::string LoadEffectSource(const char *fileName) {
+    const char *path = TextFormat("resources/shaders/glsl%i/%s", GLSL_VERSION, fileName);
+    const BundleEntry *entry = bundle.IsOpen() ? bundle.Find(path) : nullptr;
+    if (entry) return (const char *) bundle.Data(entry);
+
+    char *text = LoadFileText(path);
+    if (text == nullptr) return "";
+    std::string source = text;
+    UnloadFileText(text);
+    return source;
 }
 
 bool IsDoneLoadingAssets() {
+    loader.Upload(uploadBudget);
+
     BeginDrawing();
         ClearBackground(BLACK);
-        const char* text = "Loading Textures";
+        const char* text = TextFormat("Loading %i%%", (int) (loader.Progress() * 100));
         int textWidth = MeasureText(text, 32);
         DrawText(text, (float) GetScreenWidth() / 2 - textWidth / 2, (float) GetScreenHeight() / 2 - 50, 32, WHITE);
+
+        Rectangle bar = {(float) GetScreenWidth() / 2 - 160, (float) GetScreenHeight() / 2, 320, 8};
+        DrawRectangleRec(bar, CgreyDarkDark);
+        DrawRectangleRec({bar.x, bar.y, bar.width * loader.Progress(), bar.height}, WHITE);
     EndDrawing();
 
-    WaitTime(0.1);
-
-    while (true) {
-        if (!texturesToLoad.empty()) {
-            Textures name = texturesToLoad.begin()->first;
-            loadedTextures[name] = LoadTexture(texturesToLoad[name]);
-            texturesToLoad.erase(name);
-        } else if (!soundsToLoad.empty()) {
-            Sounds name = soundsToLoad.begin()->first;
-            loadedSounds[name] = LoadSound(soundsToLoad[name]);
-            soundsToLoad.erase(name);
-        } else {
-            LoadOther();
-            LoadShaders();
-            return true;
-        }
+    if (!loader.IsGroupDone(TitleAssets)) return false;
+
+    atlas.Build();
+    for (int index = 0; index < totalTextures; index++) {
+        Textures name = (Textures) index;
+        if (!atlas.Contains(name)) continue;
+        loadedTextures.Set(name, atlas.GetPage(name));
+        textureRects[name] = atlas.GetRegion(name);
     }
-    
-    return false;
+    spriteHandles = SpriteHandles {
+        loadedTextures.Handle(Textures::cart), loadedTextures.Handle(Textures::tractor),
+        loadedTextures.Handle(Textures::wheelLarge), loadedTextures.Handle(Textures::wheelSmall),
+        loadedTextures.Handle(Textures::halo), loadedTextures.Handle(Textures::smoke),
+        loadedTextures.Handle(Textures::items), loadedTextures.Handle(Textures::coinsheet),
+        loadedTextures.Handle(Textures::explosion), loadedTextures.Handle(Textures::pauseButtons)
+    };
+    LoadOther();
+    return true;
+}
+
+// Keeps uploading the rest in the background once the title screen is up
+void StreamAssets() {
+    if (!gameAssetsReady && loader.Upload(uploadBudget)) {
+        FinishLoadingAssets();
+    }
+}
+
+// Blocks until the in-game assets are resident, only waits if the player is faster than the loader
+void FinishLoadingAssets() {
+    if (gameAssetsReady) return;
+
+    loader.Finish(GameAssets);
+    gameAssetsReady = true;
 }
 
 bool isTransitionFinished(const char* name) {
@@ -1255,14 +1509,40 @@ bool isTransitionFinished(const char* name) {
     return false;
 }
 
+SpriteBatch &GetSpriteBatch() {
+    return batch;
+}
+
 Texture2D &GetTexture(Textures texture) {
-    return loadedTextures[texture];
+    return loadedTextures.Get(texture);
+}
+
+Texture2D &GetTexture(AssetHandle<Textures> handle) {
+    return loadedTextures.Get(handle);
+}
+
+SpriteHandles &GetSpriteHandles() {
+    return spriteHandles;
+}
+
+Rectangle GetTextureRect(Textures texture) {
+    return textureRects[texture];
+}
+
+Rectangle GetSourceRect(Textures texture, Rectangle source) {
+    Rectangle region = GetTextureRect(texture);
+    return Rectangle {region.x + source.x, region.y + source.y, source.width, source.height};
+}
+
+Rectangle GetSourceRect(Textures texture, int id, int tileWidth, int tileHeight) {
+    Rectangle region = GetTextureRect(texture);
+    return GetSourceRect(texture, GetSourceRect(id, {region.width, region.height}, tileWidth, tileHeight));
 }
 
 Sound &GetSound(Sounds sound) {
-    return loadedSounds[sound];
+    return loadedSounds.Get(sound);
 }
 
 JakeFont &GetFont(Fonts font) {
-    return loadedFonts[font];
+    return loadedFonts.Get(font);
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "debug.h"
+
+// Points at one slot of an AssetArray, the generation changes every time the slot is loaded or unloaded
+template <typename Key>
+struct AssetHandle {
+    Key key;
+    unsigned int generation;
+};
+
+// Flat array of one kind of asset indexed by its enum, a lookup is a single array load.
+// Builds with -DDEBUG report every use of a slot that isn't loaded or of a stale handle
+template <typename Key, typename T, int Count>
+class AssetArray {
+public:
+    AssetArray(const char *_kind) : kind(_kind) {};
+
+    inline void Set(Key key, const T &asset) {
+        assets[key] = asset;
+        loaded[key] = true;
+        generations[key]++;
+    }
+
+    inline void Unload(Key key) {
+        loaded[key] = false;
+        generations[key]++;
+    }
+
+    inline T &Get(Key key) {
+        Check(key, generations[key]);
+        return assets[key];
+    }
+
+    inline T &Get(AssetHandle<Key> handle) {
+        Check(handle.key, handle.generation);
+        return assets[handle.key];
+    }
+
+    inline AssetHandle<Key> Handle(Key key) {
+        return AssetHandle<Key> {key, generations[key]};
+    }
+
+    inline bool IsLoaded(Key key) {
+        return loaded[key];
+    }
+
+    inline int Size() {
+        return Count;
+    }
+
+private:
+    const char *kind;
+    T assets[Count] = {};
+    bool loaded[Count] = {};
+    unsigned int generations[Count] = {};
+
+#if defined(DEBUG)
+    bool reported[Count] = {};
+
+    inline void Check(Key key, unsigned int generation) {
+        if (reported[key]) return;
+
+        if (!loaded[key]) {
+            warning(kind << " " << (int) key << " was used before it was loaded");
+            reported[key] = true;
+        } else if (generation != generations[key]) {
+            warning(kind << " " << (int) key << " was used through a stale handle");
+            reported[key] = true;
+        }
+    }
+#else
+    inline void Check(Key, unsigned int) {}
+#endif
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <map>
+#include <vector>
+#include "raylib.h"
+
+const int atlasPageSize = 512;
+const int atlasPadding = 1;     // Transparent gap so neighbouring sheets never bleed into each other
+
+// Packs many small sprite sheets into a few large pages at load time
+class TextureAtlas {
+public:
+    struct Region {
+        int page;
+        Rectangle rect;
+    };
+
+    // Copies the image, everything has to be added before Build
+    void Add(int key, Image image);
+    void Build();
+    void Unload();
+
+    inline bool Contains(int key) {
+        return regions.find(key) != regions.end();
+    }
+
+    inline Texture2D &GetPage(int key) {
+        return pages[regions[key].page];
+    }
+
+    inline Rectangle GetRegion(int key) {
+        return regions[key].rect;
+    }
+
+    inline int PageCount() {
+        return (int) pages.size();
+    }
+
+private:
+    std::map<int, Image> pending;
+    std::map<int, Region> regions;
+    std::vector<Texture2D> pages;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include "raylib.h"
+
+#if defined(PLATFORM_WEB)
+    const int maxBatchQuads = 2048;     // rlgl's default vertex buffer size for GLES2
+#else
+    const int maxBatchQuads = 8192;
+#endif
+
+// Lower layers are drawn first. Inside a layer sprites are grouped by texture,
+// so only share a layer between sprites that don't overlap or use the same texture
+enum SpriteLayer {
+    BackgroundLayer = 0,
+    ItemLayer = 1,
+    ScoreLayer = 2,
+    TractorLayer = 3,       // Tractor::Draw uses TractorLayer + part, one layer per overlapping part
+    SmokeLayer = 16,
+    ExplosionLayer = 17,
+    HudLayer = 18,
+    PreviewLayer = 32
+};
+
+struct BatchStats {
+    int sprites = 0;
+    int drawCalls = 0;
+    int textureBinds = 0;
+};
+
+// Collects quads for a frame and submits them sorted by (layer, texture, depth) so
+// raylib's internal batch only has to break when the texture actually changes
+class SpriteBatch {
+public:
+    BatchStats stats;   // Totals of the last finished frame
+
+    void Init();
+    void Unload();
+
+    // Depth orders sprites of the same texture inside a layer, ties keep submission order.
+    // It sorts correctly from -32768 to 32767, anything outside is clamped to that range
+    void Draw(int layer, Texture2D &texture, Rectangle source, Rectangle dest, Color tint, int depth = 0);
+    void DrawRect(int layer, Rectangle dest, Color color, int depth = 0);
+
+    // Sorts and submits everything queued so far, call before drawing anything unbatched on top
+    void Flush();
+    void EndFrame();
+
+private:
+    struct Sprite {
+        unsigned long long key;
+        Texture2D texture;
+        Rectangle source;
+        Rectangle dest;
+        Color tint;
+    };
+
+    std::vector<Sprite> sprites;
+    BatchStats frame;
+    Texture2D whitePixel;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "mapped.h"
+
+// Layout of a bundle file: BundleHeader, entryCount BundleEntry records sorted by name,
+// then every blob aligned to bundleAlignment. Images are raw pixels in their raylib
+// PixelFormat, waves are interleaved PCM and texts (shader sources) end with a '\0'
+const char bundleMagic[4] = {'L', 'W', 'B', 'N'};
+const uint32_t bundleVersion = 1;
+const int bundleAlignment = 16;
+const int bundleNameLength = 64;
+
+enum BundleEntryType : uint32_t {
+    BundleImage,
+    BundleWave,
+    BundleText
+};
+
+struct BundleHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct BundleEntry {
+    char name[bundleNameLength];    // Path the game asks for, like "resources/img/cart.png"
+    uint32_t type;
+    uint32_t format;                // PixelFormat of images
+    uint64_t offset;                // From the start of the file
+    uint64_t size;
+    int32_t width;
+    int32_t height;
+    uint32_t frameCount;
+    uint32_t sampleRate;
+    uint32_t sampleSize;
+    uint32_t channels;
+};
+
+// Read only view of a bundle, blobs are pointers into the mapped file
+class AssetBundle {
+public:
+    bool Open(const char *path);
+    void Close();
+
+    inline bool IsOpen() {
+        return base != nullptr;
+    }
+
+    const BundleEntry *Find(const char *name);
+
+    inline const unsigned char *Data(const BundleEntry *entry) {
+        return base + entry->offset;
+    }
+
+private:
+    MappedFile file;
+    const unsigned char *base = nullptr;
+    size_t size = 0;
+    const BundleEntry *entries = nullptr;
+    int entryCount = 0;
+};
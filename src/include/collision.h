@@ -0,0 +1,40 @@
+#pragma once
+#include "map.h"
+
+// Result of sweeping a box through a layer. Time is the fraction of the move made before
+// the contact, position is the box's top left at that moment, snapped flush against the hitbox
+struct TileHit {
+    bool hit = false;
+    float time = 1;
+    Vector2 position = {0, 0};
+    Vector2 normal = {0, 0};
+    int tileX = -1;
+    int tileY = -1;
+    unsigned int gid = 0;
+};
+
+// Collides axis aligned boxes with the hitboxes Tiled tilesets give their tiles. Only tiles with
+// at least one hitbox are solid. Boxes are in layer pixels, the tile at x, y covers
+// x * tileSize.x to (x + 1) * tileSize.x. Queries never allocate
+class TileCollider {
+public:
+    // Copies every gid's hitboxes scaled to tileSize, rebuild when tilesets are added
+    void Build(TilesetCollection &tilesets, Vector2 tileSize);
+
+    bool Overlaps(Layer &layer, Rectangle box);
+    // First hitbox the box runs into while moving by move. Hitboxes the box already overlaps
+    // at the start are ignored so a body stuck inside terrain can still get out
+    TileHit Sweep(Layer &layer, Rectangle box, Vector2 move);
+    // Moves the box by move, sliding along whatever it hits, and returns the last hit
+    TileHit Move(Layer &layer, Rectangle &box, Vector2 move, int maxSlides = 3);
+    // Moves count boxes, hits can be nullptr
+    void MoveAll(Layer &layer, Rectangle *boxes, const Vector2 *moves, TileHit *hits, int count);
+
+private:
+    Vector2 tileSize = {16, 16};
+    std::vector<int> hitboxStarts;      // Indexed by gid, count + 1 offsets into hitboxes
+    std::vector<Rectangle> hitboxes;    // Tile local, scaled to tileSize
+
+    Rectangle FlipHitbox(Rectangle hitbox, Tile tile);
+    void SweepTile(Layer &layer, int x, int y, Rectangle box, Vector2 move, TileHit &best);
+};
@@ -4,6 +4,7 @@
 #include <raylib.h>
 
 #define print(x) std::cout << "\033[0;32m" << x << "\033[0m" << "\n";
+#define warning(x) std::cout << "\033[0;33mWarning: " << x << "\033[0m" << "\n";
 #define error(x) std::cout << "\033[0;31mError: " << x << "\033[0m" << std::endl; exit(1);
 #define ___ << ", " <<
 
@@ -4,16 +4,21 @@
 #include "map.h"
 #include "debug.h"
 #include "utils.h"
+#include "timestep.h"
+#include "items.h"
+#include "pool.h"
+#include "assets.h"
+#include "post.h"
 
-#if defined(PLATFORM_WEB)
-    #define GLSL_VERSION            100
-#else
-    #define GLSL_VERSION            330
-#endif
+const char *const bundlePath = "assets.lwb";   // Loose files in resources/ are used when it's missing
 
 const int tileWidth = 16;
 const int tileHeight = 16;
 const int itemTileSize = 12;
+const int itemLifetime = 3600;
+const int itemFadeTime = 60;
+const int maxScoreParticles = 64;
+const int maxExplosionParticles = 16;
 
 const Vector2 fruitIds = {0, 30};
 const Vector2 rottenFruitIds = {31, 40};
@@ -61,6 +66,8 @@ enum Textures {
     map3
 };
 
+const int totalTextures = Textures::map3 + 1;
+
 enum Sounds {
     LongWagonVoice,
     ExtraLongWagonVoice,
@@ -69,45 +76,20 @@ enum Sounds {
     SpeedVoice
 };
 
+const int totalSounds = Sounds::SpeedVoice + 1;
+
 enum Fonts {
     normal
 };
 
+const int totalFonts = Fonts::normal + 1;
+
 enum EffectType {
     LongWagon,
     Magnet,
     Lightning
 };
 
-enum Shaders {
-    None,
-    FX_GRAYSCALE,
-    FX_POSTERIZATION,
-    FX_DREAM_VISION,
-    FX_PIXELIZER,
-    FX_CROSS_HATCHING,
-    FX_CROSS_STITCHING,
-    FX_PREDATOR_VIEW,
-    FX_SCANLINES,
-    FX_FISHEYE,
-    FX_SOBEL,
-    FX_BLOOM,
-    FX_BLUR,
-};
-
-struct FallingItem {
-    FallingItem(Vector2 _pos, int _id, float _yVel) : pos(_pos), id(_id), yVel(_yVel), initalYVel(_yVel) {}
-
-    Vector2 pos;
-    int id;
-    float xVel = 0;
-    float yVel;
-    float initalYVel;
-    int lifetime = 0;
-    bool hasHitGround = false;
-    bool insideCart = false;
-};
-
 class GameData {
 public:
     struct Upgrade {
@@ -140,7 +122,7 @@ public:
     int inGameCoins;
     
     Textures selectedMap = Textures::map1;
-    Shaders selectedShader = Shaders::None;
+    EffectSet selectedEffects = 0;
 
     bool colorsUnlocked = false;
     bool backgroundUnlocked = false;
@@ -177,32 +159,32 @@ private:
 };
 
 
-class Particle {
+// Plain particle types, each lives in its own Pool and is stepped in its own pass
+class ScoreParticle {
 public:
-    int lifetime;
-    int timer;
+    int lifetime = 60;
+    int timer = 0;
     bool isDead = false;
-    Vector2 pos;
-    Vector2 vel;
-
-    virtual void Draw(Camera2D cam) = 0;
-};
-
-class ScoreParticle : public Particle {
-public:
-    std::string text;
     bool posative;
+    char text[16];
+    Vector2 pos;
+    Vector2 prevPos;
     
+    ScoreParticle() = default;
     ScoreParticle(int score, Vector2 position, bool isHp = false);
-    void Draw(Camera2D cam);
+    void Update();
+    void Draw(SpriteBatch &batch, Camera2D cam, float alpha);
 };
 
-class ExplosionParticle : public Particle {
+class ExplosionParticle {
 public:
+    bool isDead = false;
     Vector2 center;
 
+    ExplosionParticle() = default;
     ExplosionParticle(Vector2 _center) : center(_center) {};
-    void Draw(Camera2D cam);
+    void Update();
+    void Draw(SpriteBatch &batch, Camera2D cam);
 
 private:
     int timer = 0;
@@ -218,6 +200,8 @@ public:
 
     Transition() = default;
     Transition(const char *_name, int _totalDuration, bool _isReversed = false);
+    virtual ~Transition() = default;
+    void Update();
     virtual void Draw() = 0;
 };
 
@@ -255,12 +239,46 @@ public:
     int Get();
 };
 
-void DrawCoins(Vector2 startPos, int numOfCoins, bool updateAnimation=true);
-void SetNextShader(Shaders shader);
+// Where a run stands after its last tick, what a headless run checks
+struct RunState {
+    int ticks;
+    int health;
+    int coins;
+    int items;
+    float tractorX;         // Middles of the tractor and its cart
+    float cartX;
+    bool gameOver;
+};
+
+void InitGame();
+void StepGame(TickInput input);
+TickInput PollTickInput();
+RunState GetRunState();
+ItemStore &GetFallingItems();
+// Sounds the ticks asked for, the frame plays and clears them so ticks never need the audio device
+std::vector<Sounds> &GetTickSounds();
+
+void DrawCoins(Vector2 startPos, int numOfCoins, SpriteBatch *batch = nullptr);
+void SetNextEffects(EffectSet effects);
+// Has the effects compiled in the background so picking them doesn't stall a frame
+void WarmEffects(EffectSet effects);
 bool isTransitionFinished(const char *name);
 GameData &GetGameData();
 std::string GetGameDataString(GameData &game);
 
+SpriteBatch &GetSpriteBatch();
+// Packed sprite sheets return their atlas page, so sources have to go through GetSourceRect
 Texture2D &GetTexture(Textures texture);
+Rectangle GetTextureRect(Textures texture);
+Rectangle GetSourceRect(Textures texture, Rectangle source);
+Rectangle GetSourceRect(Textures texture, int id, int tileWidth, int tileHeight);
 Sound &GetSound(Sounds sound);
 JakeFont &GetFont(Fonts font);
+
+// Sheets drawn every frame, looked up through handles taken once the atlas is built
+struct SpriteHandles {
+    AssetHandle<Textures> cart, tractor, wheelLarge, wheelSmall, halo, smoke, items, coinsheet, explosion, pauseButtons;
+};
+
+SpriteHandles &GetSpriteHandles();
+Texture2D &GetTexture(AssetHandle<Textures> handle);
@@ -0,0 +1,79 @@
+#pragma once
+#include "pch.h"
+
+// Indices into the store that something happened to during the last Step
+struct ItemEvents {
+    std::vector<int> hitGround;
+    std::vector<int> landedInCart;
+    std::vector<int> removed;
+
+    inline void Clear() {
+        hitGround.clear();
+        landedInCart.clear();
+        removed.clear();
+    }
+};
+
+struct ItemStepInfo {
+    Rectangle cartRect;
+    float groundY;
+    float bounceVel;
+    bool magnet;
+};
+
+// Falling items stored as parallel arrays, removing an item swaps the last one into its slot
+class ItemStore {
+public:
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> xVel;
+    std::vector<float> yVel;
+    std::vector<float> initialYVel;
+    std::vector<int> ids;
+    std::vector<int> lifetimes;
+    std::vector<int> hitGround;
+    std::vector<int> insideCart;
+
+    inline int Size() {
+        return (int) ids.size();
+    }
+
+    inline bool Empty() {
+        return ids.empty();
+    }
+
+    inline Vector2 GetPos(int index) {
+        return Vector2 {x[index], y[index]};
+    }
+
+    inline Vector2 GetDrawPos(int index, float alpha) {
+        return Vector2 {prevX[index] + (x[index] - prevX[index]) * alpha, prevY[index] + (y[index] - prevY[index]) * alpha};
+    }
+
+    void Add(Vector2 pos, int id, float startYVel);
+    void Remove(int index);
+    void RemoveAll(std::vector<int> &indices);
+    void Reserve(int count);
+    void Clear();
+    void StorePrevious();
+
+    // Runs every pass for one tick, handle the events before calling RemoveAll(events.removed)
+    void Step(ItemStepInfo info, ItemEvents &events);
+
+    void BounceOnGround(ItemStepInfo &info);
+    void Integrate();
+    void SinkIntoCart(ItemStepInfo &info, ItemEvents &events);
+    void CollideWithCart(ItemStepInfo &info);
+    void Steer(ItemStepInfo &info);
+    void PullTowardsCart(ItemStepInfo &info);
+    void ApplyCartCollisions(ItemEvents &events);
+    void Rest(ItemEvents &events);
+
+private:
+    // Per tick scratch, kept around so stepping never allocates once warmed up
+    std::vector<int> landed;
+    std::vector<int> airborne;
+    std::vector<int> cartHit;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "pch.h"
+#include "bundle.h"
+
+const float uploadBudget = 0.004f;     // Seconds per frame the main thread may spend handing decoded assets to the GPU
+const int maxLoaderThreads = 4;
+
+// Decodes images and waves on worker threads, the main thread finishes them in Upload.
+// The web build has no threads so Upload decodes there as well, inside the same budget.
+// Callbacks only borrow the data, the loader frees it once they return
+class AssetLoader {
+public:
+    // Everything has to be queued before Start. Group lets the caller wait for the
+    // assets of one screen without waiting for everything else
+    void QueueImage(int group, const char *path, std::function<void(Image)> onLoaded);
+    void QueueWave(int group, const char *path, std::function<void(Wave)> onLoaded);
+
+    // Assets found in the bundle are sliced out of it instead of decoded
+    void UseBundle(AssetBundle *_bundle);
+    void Start();
+    void Stop();
+
+    // Runs finished callbacks until the budget runs out, returns true once everything is uploaded
+    bool Upload(float budget);
+    // Blocks until every asset of the group is uploaded
+    void Finish(int group);
+
+    bool IsGroupDone(int group);
+    float Progress();
+
+private:
+    struct Job {
+        int group;
+        const char *path;
+        bool isWave;
+        bool borrowed;
+        Image image;
+        Wave wave;
+        std::function<void(Image)> onImage;
+        std::function<void(Wave)> onWave;
+    };
+
+    std::deque<Job> jobs;
+    std::deque<int> pending;    // Indices into jobs that no worker has picked up
+    std::deque<int> decoded;    // Indices into jobs waiting for their callback
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobsChanged;
+    std::map<int, int> remaining;
+    AssetBundle *bundle = nullptr;
+    int uploaded = 0;
+    bool stopping = false;
+
+    void Decode(Job &job);
+    void Complete(Job &job);
+    void Release(Job &job);
+    void WorkerLoop();
+    bool UploadNext(bool wait);
+};
@@ -1,7 +1,13 @@
 #pragma once
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include "pch.h"
-#include "tinyxml2.h"
+#include "tmx.h"
 #include "debug.h"
 
 class TilesetCollection;
@@ -18,9 +24,32 @@ enum RenderOrder {
     RightUP,
 };
 
+// Tiled keeps a tile's flips in the top bits of its gid. Bit 28 is the hexagonal
+// 120 degree turn, which isn't drawn but is masked off all the same
+const unsigned int flippedHorizontally = 0x80000000;
+const unsigned int flippedVertically = 0x40000000;
+const unsigned int flippedDiagonally = 0x20000000;
+const unsigned int gidMask = 0x0fffffff;
+
+// One cell of a layer, the gid exactly as Tiled saved it
 struct Tile {
-    int gid;
-    int animationIndex = 0;
+    unsigned int cell;
+
+    inline int Gid() const {
+        return (int) (cell & gidMask);
+    }
+
+    inline bool FlippedX() const {
+        return cell & flippedHorizontally;
+    }
+
+    inline bool FlippedY() const {
+        return cell & flippedVertically;
+    }
+
+    inline bool FlippedDiagonally() const {
+        return cell & flippedDiagonally;
+    }
 };
 
 struct Frame {
@@ -28,62 +57,223 @@ struct Frame {
     int duration;
 };
 
+// Frame durations as running totals, so finding the frame for a point in time is a binary search
+struct AnimationClip {
+    std::vector<int> gids;
+    std::vector<int> frameEnds;
+    int currentGid;
+};
+
+const int streamChunkSize = 64;                     // Tiles per side of a chunk file of a streamed map
+const size_t streamBudget = 32 * 1024 * 1024;       // Bytes of streamed tiles kept in memory, the least recently seen chunks go first
+
+// Pages the tiles of a streamed map in and out one chunk file at a time. Files are read on a
+// worker thread and handed over in Update, so Get only ever touches the main thread's state
+class ChunkStream {
+public:
+    ~ChunkStream();
+
+    bool Open(const std::string &_folder, int _layerCount, int width, int height);
+    void Close();
+
+    // Requests the chunks covering area (in tiles, x and y to width and height) and a ring
+    // around it, takes in the chunks the worker finished and evicts the least recently seen ones
+    // over streamBudget. Arrived gets the indices of the chunks that came in, Edit's included
+    void Update(Rectangle area, std::vector<int> &arrived);
+
+    // Nullptr while the chunk isn't in memory
+    inline Tile *Get(int layer, int x, int y) {
+        StreamedChunk *chunk = chunks[(y / streamChunkSize) * chunksX + x / streamChunkSize].get();
+        if (chunk == nullptr) return nullptr;
+        return &chunk->tiles[(layer * streamChunkSize + y % streamChunkSize) * streamChunkSize + x % streamChunkSize];
+    }
+
+    // Like Get, but a chunk that isn't in memory is read right away. The chunk is marked edited,
+    // edited chunks stay in memory for the rest of the level and nothing is written back
+    Tile *Edit(int layer, int x, int y);
+
+    inline int ChunksX() {
+        return chunksX;
+    }
+
+    inline int ResidentCount() {
+        return (int) resident.size();
+    }
+
+private:
+    struct StreamedChunk {
+        std::vector<Tile> tiles;        // Every layer's streamChunkSize x streamChunkSize cells, one layer after another
+        unsigned int lastUsed = 0;
+        bool edited = false;
+    };
+
+    std::string folder;
+    int layerCount = 0;
+    int chunksX = 0;
+    int chunksY = 0;
+    unsigned int frame = 0;
+    std::vector<std::unique_ptr<StreamedChunk>> chunks;
+    std::vector<int> resident;
+    std::vector<bool> requested;        // Queued or being read
+    std::vector<int> paged;             // Read by Edit since the last Update
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable requestsChanged;
+    std::deque<int> requests;
+    std::vector<std::pair<int, std::unique_ptr<StreamedChunk>>> finished;
+    bool stopping = false;
+
+    void WorkerLoop();
+    std::unique_ptr<StreamedChunk> ReadChunk(int chunkIndex);
+};
+
+const int chunkSize = 16;               // Tiles per side of a cached chunk
+const int maxResidentChunks = 64;       // Chunk textures each layer keeps alive, the least recently drawn go first
+
+// Static tiles of one chunkSize x chunkSize block baked into a texture, animated tiles are drawn on top of it every frame
+struct TileChunk {
+    RenderTexture2D texture = {};
+    bool resident = false;
+    bool dirty = true;
+    unsigned int lastUsed = 0;
+    std::vector<int> animatedTiles;     // Indices into Layer::tiles
+};
+
+enum PropertyType {
+    StringProperty,
+    IntProperty,
+    FloatProperty,
+    BoolProperty,
+    ColorProperty,
+    FileProperty,       // Path relative to the map, kept in text
+    ObjectProperty      // Id of the referenced object
+};
+
+// Property names are interned once into small integer keys shared by every map.
+// Gameplay code looks a key up once and keeps it, e.g. static const int speedKey = InternProperty("speed")
+int InternProperty(const std::string &name);
+// Returns -1 for a name no map has used yet, without interning it
+int FindProperty(const char *name);
+const std::string &PropertyName(int key);
+
+// A Tiled property with its value parsed at load time
 class Property {
 public:
-    std::string name;
-	std::string type;
-	std::string value;
+    int key = -1;
+    PropertyType type = StringProperty;
+    union {
+        int intValue = 0;       // Int and object properties
+        float floatValue;
+        bool boolValue;
+        Color colorValue;
+    };
+    std::string text;           // String and file properties
+
+    // Numbers convert between each other, anything else returns fallback
+    inline int GetInt(int fallback = 0) const {
+        if (type == IntProperty || type == ObjectProperty) return intValue;
+        if (type == FloatProperty) return (int) floatValue;
+        if (type == BoolProperty) return boolValue;
+        return fallback;
+    }
 
-    inline int GetInt() const
-	{
-		if (type != "int" || value.empty()) exit(1);
-		return atoi(value.c_str());
-	}
+    inline float GetFloat(float fallback = 0) const {
+        if (type == FloatProperty) return floatValue;
+        if (type == IntProperty) return (float) intValue;
+        return fallback;
+    }
 
-	inline float GetFloat() const
-	{
-		if (type != "float" || value.empty()) exit(1);
+    inline bool GetBool(bool fallback = false) const {
+        if (type == BoolProperty) return boolValue;
+        if (type == IntProperty) return intValue != 0;
+        return fallback;
+    }
 
-		return float(atof(value.c_str()));
-	}
+    inline Color GetColor(Color fallback = BLANK) const {
+        return type == ColorProperty ? colorValue : fallback;
+    }
 
-	inline const char* GetString() const
-	{
-        if (type != "string") exit(1);
+    inline const char* GetString(const char *fallback = "") const {
+        return type == StringProperty || type == FileProperty ? text.c_str() : fallback;
+    }
 
-		return value.c_str();
-	}
+    inline const std::string &Name() const {
+        return PropertyName(key);
+    }
 };
 
+// Properties sorted by key, so a lookup is a binary search over a few ints
 class PropertyCollection {
 public:
     std::vector<Property> properties;
 
-    inline const Property* GetProperty(std::string name) {
-        for (const Property &property : properties) {
-            if (property.name == name) return &property;
-        }
-        return nullptr;
+    inline const Property* GetProperty(int key) const {
+        auto found = std::lower_bound(properties.begin(), properties.end(), key, [](const Property &property, int key) {
+            return property.key < key;
+        });
+        if (found == properties.end() || found->key != key) return nullptr;
+        return &*found;
     }
 
-    inline std::vector<Property> GetPropertyAll(std::string name) {
-        std::vector<Property> propertiesOfType;
-        for (const Property &property : properties) {
-            if (property.name == name) {
-                propertiesOfType.emplace_back(property);
-            }
-        }
-        return properties;
+    inline const Property* GetProperty(const char *name) const {
+        int key = FindProperty(name);
+        return key < 0 ? nullptr : GetProperty(key);
+    }
+
+    inline int GetInt(int key, int fallback = 0) const {
+        const Property *property = GetProperty(key);
+        return property ? property->GetInt(fallback) : fallback;
+    }
+
+    inline float GetFloat(int key, float fallback = 0) const {
+        const Property *property = GetProperty(key);
+        return property ? property->GetFloat(fallback) : fallback;
+    }
+
+    inline bool GetBool(int key, bool fallback = false) const {
+        const Property *property = GetProperty(key);
+        return property ? property->GetBool(fallback) : fallback;
     }
 
-    inline void AddProperty(std::string name, std::string type, std::string value) {
-        Property property;
-        property.name = name;
-        property.type = type;
-        property.value = value;
-        properties.push_back(property);
+    inline Color GetColor(int key, Color fallback = BLANK) const {
+        const Property *property = GetProperty(key);
+        return property ? property->GetColor(fallback) : fallback;
     }
 
+    inline const char* GetString(int key, const char *fallback = "") const {
+        const Property *property = GetProperty(key);
+        return property ? property->GetString(fallback) : fallback;
+    }
+
+    // Keeps the collection sorted, a second property with the same name replaces the first
+    void Add(const Property &property);
+    // Parses a value the way Tiled writes it, unknown types are kept as strings
+    void AddProperty(const std::string &name, const std::string &type, const std::string &value);
+};
+
+enum ObjectShape {
+    RectShape,
+    PointShape,         // Width and height are 0
+    EllipseShape,       // Inscribed in rect
+    TextShape           // Settings are in ObjectLayer::texts
+};
+
+// Text settings of a text object, kept apart so every object is the same size
+class TextObject {
+public:
+	Color textColor = BLACK;
+	int fontSize = 16;
+	bool wrap = false;
+	bool bold = false;
+	bool italic = false;
+	bool underline = false;
+	bool strikeout = false;
+	bool kerning = true;
+	std::string text;
+	std::string fontFamily;
+	std::string horizontalAlignment = "left";
+	std::string verticalAlignment = "top";
 };
 
 class Object {
@@ -91,9 +281,32 @@ public:
     int id = -1;
     std::string name;
     Rectangle rect;
+    ObjectShape shape = RectShape;
+    int text = -1;                  // Index into ObjectLayer::texts for text objects
     PropertyCollection properties; 
 };
 
+const int objectCellSize = 256;     // Pixels per side of an ObjectGrid cell, doubled while the grid has far more cells than objects
+
+// Uniform grid over the objects of one layer. Each cell lists the objects overlapping it,
+// packed one cell after another so a query only walks the cells under its area
+class ObjectGrid {
+public:
+    void Build(const std::vector<Object> &objects);
+    // Appends the index of every object overlapping area, each one once, in no particular order
+    void Query(Rectangle area, std::vector<int> &found);
+
+private:
+    Vector2 origin = {0, 0};
+    float cellSize = objectCellSize;
+    int cellsX = 0, cellsY = 0;
+    std::vector<int> cellStarts;    // cellsX * cellsY + 1 offsets into entries
+    std::vector<int> entries;
+    std::vector<Rectangle> bounds;  // Copy of every object rect so queries don't touch the objects
+    std::vector<unsigned int> seen; // Query stamp per object, objects spanning several cells are reported once
+    unsigned int stamp = 0;
+};
+
 class Layer {
 public:
     int id = -1;
@@ -101,11 +314,27 @@ public:
     float opacity = 1;
     std::string name;
     bool visible = true;
-    std::vector<Tile> tiles;
+    std::vector<Tile> tiles;            // Empty on streamed maps, the cells live in stream instead
     PropertyCollection properties;
+    ChunkStream *stream = nullptr;
+    int streamLayer = 0;
+
+    int chunksX = 0;
+    int chunksY = 0;
+    std::vector<TileChunk> chunks;
+    std::vector<int> residentChunks;
+
+    // Sizes the chunk grid to the layer, once width and height are known
+    inline void InitChunks() {
+        chunksX = (width + chunkSize - 1) / chunkSize;
+        chunksY = (height + chunkSize - 1) / chunkSize;
+        chunks.resize(chunksX * chunksY);
+    }
 
     inline Tile* Getat(Vector2 pos) {
         if (pos.x < width && pos.x >= 0 && pos.y < height && pos.y >= 0) {
+            if (stream != nullptr) return stream->Get(streamLayer, (int) pos.x, (int) pos.y);
+
             int index = (pos.y * width) + pos.x;
             if (index >= 0 && index < (int) tiles.size()) {
                 return &tiles[index];
@@ -114,13 +343,14 @@ public:
         return nullptr;
     }
 
+    // On a streamed map the cell's chunk is paged in first when it isn't in memory, so no edit is lost
     inline void SetAt(Vector2 pos, Tile tile) {
-        if (pos.x < width && pos.x >= 0 && pos.y < height && pos.y >= 0) {
-            int index = (pos.y * width) + pos.x;
-            if (index >= 0 && index < (int) tiles.size()) {
-                tiles.at(index) = tile;
-            }
-        }
+        if (pos.x >= width || pos.x < 0 || pos.y >= height || pos.y < 0) return;
+        Tile *cell = stream != nullptr ? stream->Edit(streamLayer, (int) pos.x, (int) pos.y) : Getat(pos);
+        if (cell == nullptr) return;
+
+        *cell = tile;
+        if (!chunks.empty()) chunks[((int) pos.y / chunkSize) * chunksX + (int) pos.x / chunkSize].dirty = true;
     }
 };
 
@@ -129,20 +359,52 @@ public:
     int id = -1;
     std::string name;
     PropertyCollection properties;
-    std::map<std::string, std::vector<Object>> objects;
+    std::vector<Object> objects;                    // In file order, pointers into it only live until the next Add
+    std::vector<TextObject> texts;
+    std::map<std::string, std::vector<int>> names;  // Indices into objects, by object name
+
+    inline int Add(const Object &object) {
+        objects.push_back(object);
+        names[object.name].push_back((int) objects.size() - 1);
+        indexed = false;
+        return (int) objects.size() - 1;
+    }
 
-    inline Object* GetObj(std::string type) {
-        if (objects.find(type) == objects.end()) return nullptr;
-        for (Object &obj : objects[type]) {
-            return &obj;
-        }
-        return nullptr;
+    inline Object* GetObj(std::string name) {
+        auto found = names.find(name);
+        if (found == names.end() || found->second.empty()) return nullptr;
+        return &objects[found->second.front()];
     }
     
-    inline std::vector<Object>* GetObjs(std::string type) {
-        if (objects.find(type) == objects.end()) return nullptr;
-        return &objects[type];
+    inline std::vector<Object*> GetObjs(std::string name) {
+        std::vector<Object*> found;
+        auto group = names.find(name);
+        if (group == names.end()) return found;
+
+        for (int index : group->second) {
+            found.push_back(&objects[index]);
+        }
+        return found;
+    }
+
+    inline TextObject* GetText(Object &object) {
+        if (object.text < 0 || object.text >= (int) texts.size()) return nullptr;
+        return &texts[object.text];
+    }
+
+    // Call after moving or resizing objects, the grid only sees rects as they were when it was built
+    inline void Reindex() {
+        indexed = false;
     }
+
+    // Every object overlapping area in file order, touching edges count so points on the border are found.
+    // The grid is rebuilt on the first query after objects were added
+    void Query(Rectangle area, std::vector<Object*> &found);
+
+private:
+    ObjectGrid grid;
+    std::vector<int> queryIndices;
+    bool indexed = false;
 };
 
 class Tilemap {
@@ -155,6 +417,8 @@ public:
     std::vector<std::string> layerNames;
     std::map<std::string, Layer> layers;
     std::map<std::string, ObjectLayer> objectLayers;
+    std::shared_ptr<ChunkStream> stream;       // Only on streamed maps, shared by every layer
+    unsigned int chunkFrame = 0;
 
     inline Layer* GetLayerID(int id) {
         for (auto &[name, layer] : layers) {
@@ -177,54 +441,32 @@ public:
     void Draw(TilesetCollection &tilesets, Camera2D camera, Vector2 offset = {0, 0}, Color tint = WHITE);
     void DrawLayer(std::string layerName, TilesetCollection &tilesets, Camera2D camera, Vector2 offset = {0, 0}, Color tint = WHITE);
     void DrawLayer(std::string layerName, TilesetCollection &tilesets, Camera2D camera, Rectangle area, Vector2 offset = {0, 0}, Color tint = WHITE);
+    // Area is in tiles with its width and height being the end column and row, like GetArea returns
+    void DrawLayer(Layer &layer, TilesetCollection &tilesets, Camera2D camera, Rectangle area, Vector2 offset = {0, 0}, Color tint = WHITE);
+
+    // Pages the chunks of a streamed map around the camera in and out, call once per frame before RefreshChunks
+    void StreamChunks(Camera2D camera);
+
+    // Bakes the chunks the camera can see, has to be called outside of any texture mode.
+    // Chunks that aren't baked yet are drawn tile by tile so this is only a cache
+    void RefreshChunks(TilesetCollection &tilesets, Camera2D camera);
+    void UnloadChunks();
 
     Rectangle GetArea(Camera2D camera, int tileWidth, int tileHeight);
     void Clear();
 };
 
-class TextObject : public Object {
-public:
-	Color yextColor = WHITE;
-	int fontSize = 20;
-	bool wrap = false;
-	bool bold = false;
-	bool italic = false;
-	bool underline = false;
-	bool strikeout = false;
-	bool kerning = true;
-	std::string text;
-	std::string fontFamily;
-	std::string horizontalAlignment = "left";
-	std::string verticalAlignment = "top";
-};
-
 class Tileset {
 public:
     std::string name;
     std::string path;
-    std::map<int, std::vector<Frame>> animations;
+    std::map<int, std::vector<Frame>> animations;       // Keyed by local id + 1 as parsed, TilesetCollection flattens them
     std::map<int, std::vector<Rectangle>> hitboxes;
     int width, height, tileWidth, tileHeight, tileCount;
     int startingGid = 1;
     Texture2D image;
     PropertyCollection properties;
-    
-    inline std::vector<Rectangle> GetHitbox(int gid) {
-        gid -= startingGid - 1;
-        if (hitboxes.find(gid) == hitboxes.end()) {
-            return std::vector<Rectangle>();
-        }
-        return hitboxes[gid];
-    }
 
-    inline std::vector<Frame> GetAnimation(int gid) {
-        gid -= startingGid - 1;
-        if (animations.find(gid) == animations.end()) {
-            return std::vector<Frame>();
-        }
-        return animations[gid];
-    }
-    
     inline Rectangle GetSourceRect(int gid) {
         gid -= startingGid; // Don't subtract 1 here because top left in this context is id 0
         int x = gid % width;
@@ -234,21 +476,59 @@ public:
 
 };
 
+// Everything the render and collision paths need to know about one gid
+struct TileInfo {
+    Texture2D image = {};
+    Rectangle source = {};
+    int tileset = -1;       // Index into TilesetCollection::tilesets, -1 when no tileset covers the gid
+    int clip = -1;          // Index into TilesetCollection::clips
+    int hitboxStart = 0;    // Range in TilesetCollection::hitboxRects
+    int hitboxCount = 0;
+};
+
+struct HitboxSpan {
+    const Rectangle *first;
+    const Rectangle *last;
+
+    inline const Rectangle *begin() const { return first; }
+    inline const Rectangle *end() const { return last; }
+    inline int size() const { return (int) (last - first); }
+};
+
 class TilesetCollection {
 public:
     std::vector<Tileset> tilesets;
+    std::vector<TileInfo> tiles;                // Indexed by gid, entry 0 is the empty tile
+    std::vector<AnimationClip> clips;
+    std::vector<Rectangle> hitboxRects;
     int tileCount;
 
     void AddTileset(const char* path, Texture2D image);
     void AddTileset(Texture2D image, int tileWidth, int tileHeight);
 
+    // Advances every animated tile to the frame for this time, call once per frame with GetTime()
+    void Animate(double time);
+
+    inline TileInfo &GetTile(int gid) {
+        if ((unsigned int) gid >= tiles.size()) gid = 0;
+        return tiles[gid];
+    }
+
+    // Gid to draw this frame, the gid itself when it isn't animated
+    inline int GetFrameGid(int gid) {
+        int clip = GetTile(gid).clip;
+        return clip < 0 ? gid : clips[clip].currentGid;
+    }
+
+    inline HitboxSpan GetHitboxes(int gid) {
+        TileInfo &tile = GetTile(gid);
+        const Rectangle *first = hitboxRects.data() + tile.hitboxStart;
+        return HitboxSpan {first, first + tile.hitboxCount};
+    }
+
     inline Tileset* Get(int gid) {
-        for (Tileset &tileset : tilesets) {
-            if (tileset.startingGid <= gid && tileset.startingGid + tileset.tileCount > gid) {
-                return &tileset;
-            }
-        }
-        return nullptr;
+        int tileset = GetTile(gid).tileset;
+        return tileset < 0 ? nullptr : &tilesets[tileset];
     }
     
     inline Tileset* Get(const char* name) {
@@ -259,9 +539,13 @@ public:
         }
         return nullptr;
     }
+
+private:
+    void AddTiles(Tileset &tileset);
 };
 
-void DrawTile(int gid, Vector2 pos, TilesetCollection &tilesets, Camera2D cam, Color tint = WHITE, bool flippedX = false, bool flippedY = false);
+// Gid may carry Tiled's flip bits, flippedX and flippedY flip on top of them
+void DrawTile(unsigned int gid, Vector2 pos, TilesetCollection &tilesets, Camera2D cam, Color tint = WHITE, bool flippedX = false, bool flippedY = false);
 
 inline Rectangle GetSourceRect(int gid, Vector2 textureSize, int tileWidth, int tileHeight) {
     int x = gid % ((int) textureSize.x / tileWidth);
@@ -269,6 +553,15 @@ inline Rectangle GetSourceRect(int gid, Vector2 textureSize, int tileWidth, int
     return Rectangle {(float) x * tileWidth, (float) y * tileHeight, (float) tileWidth, (float) tileHeight};
 }
 
+// Threads inflating the compressed layers of a map as it loads, 0 is one per core
+extern int layerDecodeThreads;
+
+// LoadSet and LoadMap read the compiled .lwmap next to the file when it is up to date
 Tileset LoadSet(const char* filename);
 Tilemap LoadMap(const char* filename);
-Tilemap LoadMap(const char* filename, std::function<Object(tinyxml2::XMLElement*)> objectInitialiser);
+
+// These always parse the Tiled file, a custom object initialiser needs the XML of every object.
+// The initialiser gets the layer the object goes to so it can add text settings to it
+Tileset LoadSetSource(const char* filename);
+Tilemap LoadMapSource(const char* filename);
+Tilemap LoadMap(const char* filename, std::function<Object(const TmxElement &, ObjectLayer &)> objectInitialiser);
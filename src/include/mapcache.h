@@ -0,0 +1,163 @@
+#pragma once
+#include <cstdint>
+#include "map.h"
+
+// Compiled form of a .tmx or .tsx file, written next to it as "<file>.lwmap" by "make maps".
+// Layout: MapCacheHeader, then each table at its offset aligned to mapCacheAlignment.
+// Strings live once in the strings table and everything else refers to them by offset
+const char mapCacheMagic[4] = {'L', 'W', 'M', 'P'};
+const uint32_t mapCacheVersion = 4;
+const int mapCacheAlignment = 16;
+const char mapCacheExtension[] = ".lwmap";
+
+enum MapCacheKind : uint32_t {
+    CachedMapFile,
+    CachedTilesetFile,
+    CachedStreamedMapFile   // Layers hold no tiles, they are in chunk files under chunkFolder
+};
+
+enum MapCacheTables {
+    StringsTable,           // '\0' terminated strings, count is in bytes
+    PropertiesTable,        // CachedProperty
+    LayersTable,            // CachedLayer
+    TilesTable,             // uint32_t cells of every layer with their flip bits, one after another
+    ObjectLayersTable,      // CachedObjectLayer
+    ObjectsTable,           // CachedObject, grouped by layer in file order
+    TextsTable,             // CachedText of text objects
+    TilesetTable,           // One CachedTileset in tileset files
+    FramesTable,            // CachedFrame
+    HitboxesTable,          // CachedHitbox
+    mapCacheTableCount
+};
+
+struct MapCacheTable {
+    uint64_t offset;
+    uint64_t count;
+};
+
+// Range in the properties table
+struct CachedProperties {
+    uint32_t first;
+    uint32_t count;
+};
+
+struct MapCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t kind;
+    int32_t width;
+    int32_t height;
+    int32_t tileWidth;
+    int32_t tileHeight;
+    int32_t orientation;
+    int32_t renderOrder;
+    CachedProperties properties;
+    uint32_t chunkFolder;       // String, only set on streamed maps
+    uint32_t reserved;
+    MapCacheTable tables[mapCacheTableCount];
+};
+
+// Already parsed, value holds the bits of Property's union and text its string
+struct CachedProperty {
+    uint32_t name;
+    uint32_t type;              // PropertyType
+    uint32_t value;
+    uint32_t text;
+};
+
+struct CachedLayer {
+    uint32_t name;
+    int32_t id;
+    int32_t width;
+    int32_t height;
+    float opacity;
+    uint32_t visible;
+    uint64_t firstTile;
+    CachedProperties properties;
+};
+
+struct CachedObjectLayer {
+    uint32_t name;
+    int32_t id;
+    uint32_t firstObject;
+    uint32_t objectCount;
+    CachedProperties properties;
+};
+
+struct CachedObject {
+    uint32_t name;
+    int32_t id;
+    float x, y, width, height;
+    uint32_t shape;
+    int32_t text;               // Index into the texts table, -1 unless shape is TextShape
+    CachedProperties properties;
+};
+
+enum CachedTextFlags : uint32_t {
+    TextWrap = 1,
+    TextBold = 2,
+    TextItalic = 4,
+    TextUnderline = 8,
+    TextStrikeout = 16,
+    TextKerning = 32
+};
+
+struct CachedText {
+    uint32_t text;
+    uint32_t fontFamily;
+    uint32_t horizontalAlignment;
+    uint32_t verticalAlignment;
+    int32_t fontSize;
+    uint32_t flags;
+    unsigned char color[4];
+};
+
+struct CachedTileset {
+    uint32_t name;
+    uint32_t path;
+    int32_t width;
+    int32_t height;
+    int32_t tileWidth;
+    int32_t tileHeight;
+    int32_t tileCount;
+    int32_t startingGid;
+};
+
+struct CachedFrame {
+    int32_t tile;           // Key of Tileset::animations
+    int32_t gid;
+    int32_t duration;
+};
+
+struct CachedHitbox {
+    int32_t tile;           // Key of Tileset::hitboxes
+    float x, y, width, height;
+};
+
+// A chunk file of a streamed map, "<chunkFolder>/<x>_<y>.lwc" in chunks. It is followed by
+// every layer's streamChunkSize x streamChunkSize cells, cells past the map edge are 0.
+// Chunks where every cell is 0 have no file
+const char streamChunkMagic[4] = {'L', 'W', 'C', 'K'};
+const char streamChunkExtension[] = ".lwc";
+
+struct StreamChunkHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t chunkX;
+    int32_t chunkY;
+    uint32_t layerCount;
+    uint32_t chunkSize;
+};
+
+std::string MapCachePath(const char *source);
+std::string ChunkFolderPath(const char *source);
+std::string ChunkFilePath(const std::string &chunkFolder, int chunkX, int chunkY);
+// True when the cache exists and was written after the source was last changed
+bool IsMapCacheFresh(const char *source);
+
+bool SaveMapCache(Tilemap &map, const char *path);
+// Writes the map's tiles as chunk files under chunkFolder and the rest as a streamed map cache
+bool SaveStreamedMapCache(Tilemap &map, const char *path, const char *chunkFolder);
+bool SaveTilesetCache(Tileset &tileset, const char *path);
+bool LoadMapCache(const char *path, Tilemap &map);
+bool LoadTilesetCache(const char *path, Tileset &tileset);
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+
+// Read only view of a whole file. Desktop builds map it, the web build reads it
+// from the preloaded file system into one block instead
+class MappedFile {
+public:
+    bool Open(const char *path);
+    void Close();
+
+    inline bool IsOpen() {
+        return data != nullptr;
+    }
+
+    inline const unsigned char *Data() {
+        return data;
+    }
+
+    inline size_t Size() {
+        return size;
+    }
+
+private:
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    void *mapping = nullptr;
+};
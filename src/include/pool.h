@@ -0,0 +1,63 @@
+#pragma once
+
+// Fixed capacity array of one particle type, nothing is allocated after startup
+template <typename T, int Capacity>
+class Pool {
+public:
+    inline int Size() {
+        return count;
+    }
+
+    inline int GetCapacity() {
+        return Capacity;
+    }
+
+    // Most particles that were ever alive at once
+    inline int HighWaterMark() {
+        return highWaterMark;
+    }
+
+    // Spawns that were thrown away because the pool was full
+    inline int Dropped() {
+        return dropped;
+    }
+
+    inline T &operator [] (int index) {
+        return items[index];
+    }
+
+    inline T *begin() {
+        return items;
+    }
+
+    inline T *end() {
+        return items + count;
+    }
+
+    inline bool Spawn(const T &item) {
+        if (count == Capacity) {
+            dropped++;
+            return false;
+        }
+
+        items[count++] = item;
+        if (count > highWaterMark) highWaterMark = count;
+        return true;
+    }
+
+    // Moves the last particle into the gap, iterate backwards when removing during a pass
+    inline void Remove(int index) {
+        count--;
+        if (index != count) items[index] = items[count];
+    }
+
+    inline void Clear() {
+        count = 0;
+    }
+
+private:
+    T items[Capacity];
+    int count = 0;
+    int highWaterMark = 0;
+    int dropped = 0;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "raylib.h"
+#include "shadercache.h"
+
+#if defined(PLATFORM_WEB)
+    #define GLSL_VERSION            100
+#else
+    #define GLSL_VERSION            330
+#endif
+
+const int postDownscale = 2;            // Bloom and blur run at this fraction of the scene's resolution
+const int bloomBlurIterations = 2;      // Across and down blur pairs, each one widens the glow
+const float bloomStrength = 0.8f;       // How much of the glow is added back over the scene
+
+enum Shaders {
+    None,
+    FX_GRAYSCALE,
+    FX_POSTERIZATION,
+    FX_DREAM_VISION,
+    FX_PIXELIZER,
+    FX_CROSS_HATCHING,
+    FX_CROSS_STITCHING,
+    FX_PREDATOR_VIEW,
+    FX_SCANLINES,
+    FX_FISHEYE,
+    FX_SOBEL,
+    FX_BLOOM,
+    FX_BLUR,
+};
+
+const int totalShaders = FX_BLUR + 1;
+
+// The effects stacked on the frame, one bit per Shaders value. None is the empty set
+typedef unsigned int EffectSet;
+
+inline EffectSet EffectBit(Shaders shader) {
+    return shader == None ? 0 : 1u << shader;
+}
+
+inline bool HasEffect(EffectSet effects, Shaders shader) {
+    return (effects & EffectBit(shader)) != 0;
+}
+
+// Fragment shader applying every effect in the set in a single pass. Effects that move where
+// the frame is read from wrap each other's fetch, fisheye outermost, and effects that only
+// recolor run one after another on the result. Bloom and blur read the half size result of
+// the offscreen passes from texture1
+std::string GenerateEffectShader(EffectSet effects, int glslVersion);
+
+// Applies the selected effects to a finished frame. Bloom and blur ping-pong between two small
+// targets first, then one fused program per combination draws everything else while the frame
+// goes to the screen, so only that last draw touches every pixel of it.
+// Nothing is compiled up front, each program is loaded from the shader cache or compiled the
+// first time its combination is drawn or warmed
+class PostChain {
+public:
+    // loadSource reads a shader file from the effect folder, for the bloom and blur passes
+    void Init(std::function<std::string(const char *fileName)> _loadSource);
+    // Unloads the targets and every program
+    void Unload();
+
+    // Runs the offscreen passes, has to be called outside of drawing and texture modes
+    void Prepare(EffectSet _effects, RenderTexture2D &_scene);
+    // Draws the prepared scene to dest on the current framebuffer
+    void Draw(Rectangle dest);
+
+    // Queues a combination that's likely to be picked soon, it's loaded in CompilePending
+    void Warm(EffectSet set);
+    // Loads at most one queued combination, called once a frame so warming never stalls one for long
+    void CompilePending();
+
+    inline ShaderCacheStats &Stats() {
+        return cache.stats;
+    }
+
+private:
+    struct Program {
+        Shader shader;
+        int sizeLocation;       // Size of what the frame is drawn to
+        int resultLocation;     // The bloom or blur result
+    };
+
+    std::function<std::string(const char *fileName)> loadSource;
+    ShaderCache cache;
+    Shader brightPass = {};
+    Shader blur = {};
+    EffectSet effects = 0;
+    Program *program = nullptr;
+    RenderTexture2D *scene = nullptr;
+    RenderTexture2D targets[2] = {};
+    std::unordered_map<EffectSet, Program> programs;
+    std::vector<EffectSet> pending;
+
+    Program &GetProgram(EffectSet set);
+    void LoadPass(Shader &pass, const char *fileName);
+    void Resize(int width, int height);
+    void UnloadTargets();
+    void Pass(Shader pass, Texture2D source, RenderTexture2D &into, Vector2 direction);
+    void SetSize(Shader pass, Vector2 size);
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include "map.h"
+
+// Fixed point key of a depth in map pixels, keys of deeper things compare greater as plain integers
+uint32_t DepthKey(float depth);
+
+// Sorts order so keys[order[i]] ascend, keeping equal keys in the order they were added.
+// Scratch holds a second copy of the indices between passes
+void RadixSort(const std::vector<uint32_t> &keys, std::vector<int> &order, std::vector<int> &scratch);
+
+// Draws tile rows and sprites back to front by depth, which is the y in map pixels where
+// something touches the ground. A sprite whose feet are lower than a row is drawn over it,
+// so the player walks in front of a tree's trunk and behind its crown. Everything is
+// recorded during the frame and sorted once in Flush, nothing allocates once warmed up
+class RenderQueue {
+public:
+    // Queues every row of the layer inside area, area being what Tilemap::GetArea returns.
+    // Rows sort by their top edge shifted down by depthOffset rows, so a layer holding the
+    // upper half of tall props can sort with the base row they stand on
+    void AddLayer(Tilemap &map, Layer &layer, Rectangle area, int depthOffset = 0, Vector2 offset = {0, 0}, Color tint = WHITE);
+    // Dest is in map pixels, the camera is applied when the queue is flushed
+    void AddSprite(Texture2D texture, Rectangle source, Rectangle dest, float depth, Color tint = WHITE);
+    void AddTile(unsigned int gid, Vector2 pos, float depth, Color tint = WHITE);
+    // For anything with its own draw function, like the player
+    void AddCustom(float depth, std::function<void()> draw);
+
+    void Flush(TilesetCollection &tilesets, Camera2D camera);
+    void Clear();
+
+    inline int Size() {
+        return (int) commands.size();
+    }
+
+private:
+    enum CommandKind {
+        TileRowCommand,
+        SpriteCommand,
+        TileCommand,
+        CustomCommand
+    };
+
+    struct Command {
+        CommandKind kind;
+        Tilemap *map;
+        Layer *layer;
+        Rectangle area;         // One row, in GetArea's form
+        Texture2D texture;
+        Rectangle source;
+        Rectangle dest;
+        unsigned int gid;
+        Vector2 offset;
+        Color tint;
+        int custom;             // Index into customs
+    };
+
+    std::vector<Command> commands;
+    std::vector<uint32_t> keys;
+    std::vector<int> order;
+    std::vector<int> scratch;
+    std::vector<std::function<void()>> customs;
+
+    void Add(const Command &command, float depth);
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "raylib.h"
+
+// Linked program binaries, one "<hash>.lwsh" file each under the cache folder. The hash covers
+// the driver, raylib's version and the fragment source, so a driver update or an edited effect
+// just misses and compiles again. Layout: ShaderCacheHeader, then the binary.
+// The web build has no program binaries and always compiles
+const char shaderCacheMagic[4] = {'L', 'W', 'S', 'H'};
+const uint32_t shaderCacheVersion = 1;
+const char shaderCacheFolder[] = "shadercache";
+const char shaderCacheExtension[] = ".lwsh";
+
+struct ShaderCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t hash;          // Checked again in case two keys share a file name
+    uint32_t format;        // As glGetProgramBinary reports it
+    uint32_t size;
+};
+
+struct ShaderCacheStats {
+    int compiled = 0;
+    int cached = 0;
+    double compileTime = 0;     // Seconds spent compiling
+    double cacheTime = 0;       // Seconds spent loading binaries
+};
+
+// Loads fragment shaders over raylib's default vertex shader. Needs the window's context
+class ShaderCache {
+public:
+    ShaderCacheStats stats;
+
+    // Reads the driver's strings and finds the program binary entry points
+    void Init(const char *_folder = shaderCacheFolder);
+    // The cached binary when there is one that still links, compiles and stores it otherwise.
+    // Returns raylib's default shader when the source doesn't compile, like LoadShaderFromMemory
+    Shader Load(const std::string &fragmentCode);
+
+private:
+    std::string folder;
+    std::string driver;
+    bool binaries = false;
+
+    uint64_t Key(const std::string &fragmentCode);
+    std::string PathOf(uint64_t key);
+    unsigned int LoadBinary(uint64_t key);
+    void SaveBinary(uint64_t key, unsigned int program);
+};
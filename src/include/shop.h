@@ -24,5 +24,6 @@ bool isShopOpen();
 void LoadShop();
 void InitShop();
 void UpdateShop(GameData &game, int bgOpacity=200);
+void StepShop();
 void setShopPanel(Panel newPanel);
 void setShopStatus(bool status);
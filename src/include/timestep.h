@@ -0,0 +1,46 @@
+#pragma once
+
+const int tickRate = 60;
+const float tickDuration = 1.0f / tickRate;
+const float maxFrameTime = 0.25f;   // Drop time after long stalls instead of spiralling
+
+class FixedStep {
+public:
+    float accumulator = 0;
+    long totalTicks = 0;
+
+    // Feed the real time of the last frame, returns how many simulation ticks to run
+    inline int Advance(float frameTime) {
+        if (frameTime > maxFrameTime) frameTime = maxFrameTime;
+        if (frameTime < 0) frameTime = 0;
+
+        accumulator += frameTime;
+        int ticks = 0;
+        while (accumulator >= tickDuration) {
+            accumulator -= tickDuration;
+            ticks++;
+        }
+        totalTicks += ticks;
+        return ticks;
+    }
+
+    // How far the renderer is between the previous and current tick (0 - 1)
+    inline float Alpha() {
+        return accumulator / tickDuration;
+    }
+
+    inline void Reset() {
+        accumulator = 0;
+        totalTicks = 0;
+    }
+};
+
+// Input sampled once per frame and handed to every tick so the simulation never talks to the window
+struct TickInput {
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+    bool pointerDown = false;
+    float pointerX = 0;
+};
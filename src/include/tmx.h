@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+
+const int tmxBlockSize = 64 * 1024;     // Bytes read from the file at a time, and the longest piece of text handed out
+
+// One element and everything inside it, only built for small parts of a file like objects and tiles
+class TmxElement {
+public:
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::string text;
+    std::vector<TmxElement> children;
+
+    const char *Attribute(const char *attribute, const char *fallback = nullptr) const;
+    int IntAttribute(const char *attribute, int fallback = 0) const;
+    float FloatAttribute(const char *attribute, float fallback = 0) const;
+    bool BoolAttribute(const char *attribute, bool fallback = false) const;
+
+    // nullptr when there is no such child
+    const TmxElement *FirstChild(const char *childName) const;
+};
+
+// Pull parser for the XML that Tiled writes. The file is read a block at a time and only
+// the current element is kept, so long layer data never sits in memory as text
+class TmxReader {
+public:
+    enum Event {
+        StartElement,   // Element() holds the name and attributes
+        EndElement,     // Also sent right after the start of an empty element like <tile/>
+        Text,           // GetText() holds the next piece, long runs arrive in several pieces
+        EndOfFile,
+        Error
+    };
+
+    ~TmxReader();
+
+    bool Open(const char *path);
+    void Close();
+    Event Next();
+
+    // Moves to the next start element with this name, at any depth
+    bool FindElement(const char *name);
+    // Moves to the next element directly inside the one that was open at parentDepth,
+    // returns false once that element ends. Anything the caller didn't read is skipped
+    bool NextChild(int parentDepth);
+    // Reads the rest of the current element into a tree, call right after its StartElement
+    TmxElement ReadElement();
+
+    inline TmxElement &Element() {
+        return element;
+    }
+
+    inline const std::string &GetText() {
+        return text;
+    }
+
+    // Elements open right now, the current one included
+    inline int Depth() {
+        return depth;
+    }
+
+    inline bool Failed() {
+        return failed;
+    }
+
+private:
+    FILE *file = nullptr;
+    std::vector<char> buffer;
+    int position = 0;
+    int length = 0;
+    TmxElement element;
+    std::string text;
+    int depth = 0;
+    bool emptyElement = false;
+    bool failed = false;
+
+    inline int Peek() {
+        if (position == length && !Refill()) return EOF;
+        return (unsigned char) buffer[position];
+    }
+
+    inline int Get() {
+        int character = Peek();
+        if (character != EOF) position++;
+        return character;
+    }
+
+    bool Refill();
+    Event Fail();
+    void SkipWhitespace();
+    bool Expect(const char *expected);
+    bool SkipPast(const char *terminator);
+    bool ReadName(std::string &name);
+    bool ReadEntity(std::string &out);
+    bool ReadAttributeValue(int quote, std::string &value);
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "game.h"
 #include "pch.h"
+#include "timestep.h"
 
 struct SmokeParticle {
     int lifetime;
@@ -8,9 +9,26 @@ struct SmokeParticle {
     int type;
     Color color;
     Vector2 pos;
+    Vector2 prevPos;
     Vector2 vel;
 };
 
+// Which settled frame of the bob, squash and bump animation the tractor is in
+struct TractorPose {
+    int bob;                // Pixels the body is lifted, 0 to 2
+    bool narrow;            // Body a pixel in from each side
+    bool tall;              // Body a pixel taller
+    int wheelBump;          // 0 none, 1 large wheel, 2 small wheel lifted a pixel
+    bool cartUp;
+    bool cartWheelBump;
+};
+
+// Draws every pose of the body and the cart once, so a settled tractor is two quads instead
+// of seven. Only does anything when the color differs from the last build, and has to be
+// called outside of texture modes since it draws into its own target
+void PrepareTractorSprites(Color color);
+void UnloadTractorSprites();
+
 class Tractor {
 public:
     int idleAnimationTimer;
@@ -20,12 +38,16 @@ public:
     int rainbowTimer;
 
     float cartX;
+    float prevCartX;
     float ySquish;
     
     bool facingRight;
     bool isMoving;
     bool isLongWagon;
     bool isRainbow;
+    bool cartWheelBump;
+    bool wheelLargeBump;
+    bool wheelSmallBump;
     Color color;
 
     int smokeParticleTimer;
@@ -33,13 +55,18 @@ public:
 
     Vector2 momentum;
     Rectangle rect;
+    Rectangle prevRect;
     Rectangle hitbox;
     
     void Init(int sw, Camera2D cam, int startY);
-    void Update(Camera2D cam, GameData &game, bool canMove=true, float customSpeed=-1);
-    void DrawParticles(Camera2D cam, bool updateParticles=true);
-    void Draw(Camera2D cam, bool updateAnimations=true);
+    void StorePrevious();
+    void Update(Camera2D cam, GameData &game, TickInput input, int sw, bool canMove=true, float customSpeed=-1);
+    void Animate();
+    void UpdateParticles();
+    void DrawParticles(SpriteBatch &batch, Camera2D cam, float alpha=1);
+    void Draw(SpriteBatch &batch, Camera2D cam, float alpha=1, int layer=TractorLayer);
 
+    TractorPose GetPose(float cartX, float rectX);
     Rectangle GetTractorRect();
     Rectangle GetCartRect();
 };
\ No newline at end of file
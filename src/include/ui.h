@@ -1,5 +1,6 @@
 #pragma once
 #include "pch.h"
+#include "batch.h"
 
 struct BorderBox {
     Rectangle topleft;
@@ -27,10 +28,11 @@ public:
     std::map<char, Rectangle> letters;
 
     JakeFont() = default;
-    JakeFont(Texture2D text, std::string chars, int _spaceSize, Color splitColor = BLACK);
+    // Region is where the font strip sits inside the texture, letters are stored in texture coordinates
+    JakeFont(Texture2D text, Rectangle region, std::string chars, int _spaceSize, Color splitColor = BLACK);
 
     int Measure(std::string text);
-    void Render(std::string text, Vector2 pos, float size, Color color);
+    void Render(std::string text, Vector2 pos, float size, Color color, SpriteBatch *batch = nullptr, int layer = HudLayer);
     void SetValues(int _letterDistance, int _lineOffset);
 };
 
@@ -73,10 +73,18 @@ inline Color Morph(float percentage, Color from, Color to) {
     };
 }
 
+inline float Interpolate(float from, float to, float alpha) {
+    return from + (to - from) * alpha;
+}
+
+inline Vector2 Interpolate(Vector2 from, Vector2 to, float alpha) {
+    return Vector2 {Interpolate(from.x, to.x, alpha), Interpolate(from.y, to.y, alpha)};
+}
+
 template <typename T>
 inline void clearHeapVector(std::vector<T*> &array) {
     for (auto &pointer : array) {
-        free(pointer);
+        delete pointer;
     }
     array.clear();
 }
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include <cmath>
+#include <algorithm>
+#include "items.h"
+#include "game.h"
+
+inline float ItemGravity(float initialYVel) {
+    float gravity = initialYVel / 26;
+    return gravity < 0.03f ? 0.03f : gravity;
+}
+
+// Bitwise ands and plain compares (no fabs/fmin/fmax or !) keep the passes free of branches so they vectorize
+inline bool Overlaps(float ax, float ay, float aw, float ah, Rectangle b) {
+    return (ax < b.x + b.width) & (ax + aw > b.x) & (ay < b.y + b.height) & (ay + ah > b.y);
+}
+
+void ItemStore::Add(Vector2 pos, int id, float startYVel) {
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    prevX.push_back(pos.x);
+    prevY.push_back(pos.y);
+    xVel.push_back(0);
+    yVel.push_back(startYVel);
+    initialYVel.push_back(startYVel);
+    ids.push_back(id);
+    lifetimes.push_back(0);
+    hitGround.push_back(false);
+    insideCart.push_back(false);
+}
+
+void ItemStore::Remove(int index) {
+    int last = Size() - 1;
+    if (index != last) {
+        x[index] = x[last];
+        y[index] = y[last];
+        prevX[index] = prevX[last];
+        prevY[index] = prevY[last];
+        xVel[index] = xVel[last];
+        yVel[index] = yVel[last];
+        initialYVel[index] = initialYVel[last];
+        ids[index] = ids[last];
+        lifetimes[index] = lifetimes[last];
+        hitGround[index] = hitGround[last];
+        insideCart[index] = insideCart[last];
+    }
+
+    x.pop_back();
+    y.pop_back();
+    prevX.pop_back();
+    prevY.pop_back();
+    xVel.pop_back();
+    yVel.pop_back();
+    initialYVel.pop_back();
+    ids.pop_back();
+    lifetimes.pop_back();
+    hitGround.pop_back();
+    insideCart.pop_back();
+}
+
+void ItemStore::RemoveAll(std::vector<int> &indices) {
+    // Highest index first so every item moved into a gap has already been checked
+    std::sort(indices.begin(), indices.end());
+    for (int index = (signed) indices.size() - 1; index > -1; index--) {
+        Remove(indices[index]);
+    }
+    indices.clear();
+}
+
+void ItemStore::Reserve(int count) {
+    x.reserve(count);
+    y.reserve(count);
+    prevX.reserve(count);
+    prevY.reserve(count);
+    xVel.reserve(count);
+    yVel.reserve(count);
+    initialYVel.reserve(count);
+    ids.reserve(count);
+    lifetimes.reserve(count);
+    hitGround.reserve(count);
+    insideCart.reserve(count);
+    landed.reserve(count);
+    airborne.reserve(count);
+    cartHit.reserve(count);
+}
+
+void ItemStore::Clear() {
+    x.clear();
+    y.clear();
+    prevX.clear();
+    prevY.clear();
+    xVel.clear();
+    yVel.clear();
+    initialYVel.clear();
+    ids.clear();
+    lifetimes.clear();
+    hitGround.clear();
+    insideCart.clear();
+}
+
+void ItemStore::StorePrevious() {
+    int count = Size();
+    float *px = x.data(), *py = y.data(), *ppx = prevX.data(), *ppy = prevY.data();
+    for (int i = 0; i < count; i++) {
+        ppx[i] = px[i];
+        ppy[i] = py[i];
+    }
+}
+
+void ItemStore::Step(ItemStepInfo info, ItemEvents &events) {
+    int count = Size();
+    landed.resize(count);
+    airborne.resize(count);
+    cartHit.resize(count);
+    events.Clear();
+
+    BounceOnGround(info);
+    for (int i = 0; i < count; i++) {
+        if (landed[i]) events.hitGround.push_back(i);
+    }
+
+    SinkIntoCart(info, events);
+    Integrate();
+    CollideWithCart(info);
+    Steer(info);
+    ApplyCartCollisions(events);
+    Rest(events);
+}
+
+void ItemStore::BounceOnGround(ItemStepInfo &info) {
+    int count = Size();
+    float *py = y.data(), *vy = yVel.data(), *init = initialYVel.data();
+    int *hit = hitGround.data(), *cart = insideCart.data(), *land = landed.data();
+    float groundY = info.groundY;
+    float bounceVel = info.bounceVel;
+
+    for (int i = 0; i < count; i++) {
+        int grounded = (cart[i] == 0) & (py[i] >= groundY);
+        int first = grounded & (hit[i] == 0);
+        float gravity = ItemGravity(init[i]);
+
+        // Both outcomes are computed up front so the selects below stay branch free
+        float v = vy[i];
+        float quarter = v / 4;
+        float firstBounce = quarter > bounceVel ? -quarter : -bounceVel;
+        float nextBounce = -v + gravity * 10;
+        float bounced = first ? firstBounce : nextBounce;
+        int settled = (bounced < gravity) & (bounced > -gravity);
+        bounced = settled ? 0 : bounced;
+
+        vy[i] = grounded ? bounced : v;
+        py[i] = grounded ? groundY : py[i];
+        hit[i] = hit[i] | grounded;
+        land[i] = first;
+    }
+}
+
+void ItemStore::SinkIntoCart(ItemStepInfo &info, ItemEvents &events) {
+    int count = Size();
+    Rectangle cartRect = info.cartRect;
+    float cartBottom = cartRect.y + cartRect.height;
+
+    for (int i = 0; i < count; i++) {
+        if (!insideCart[i]) continue;
+
+        if (x[i] < cartRect.x) x[i] = cartRect.x;
+        if (x[i] + itemTileSize >= cartRect.x + cartRect.width) x[i] = (cartRect.x + cartRect.width) - itemTileSize - 1;
+
+        // Fully sunk below the bottom of the cart, Integrate hasn't moved it yet this tick
+        if (y[i] + yVel[i] - itemTileSize >= cartBottom) {
+            events.removed.push_back(i);
+        }
+    }
+}
+
+void ItemStore::Integrate() {
+    int count = Size();
+    float *py = y.data(), *vy = yVel.data(), *init = initialYVel.data();
+    int *hit = hitGround.data(), *cart = insideCart.data(), *air = airborne.data();
+
+    for (int i = 0; i < count; i++) {
+        py[i] += vy[i];
+    }
+
+    for (int i = 0; i < count; i++) {
+        int moving = (cart[i] == 0) & (vy[i] != 0);
+        int falling = moving & (vy[i] < init[i]);
+        float gravity = ItemGravity(init[i]);
+        vy[i] += falling ? gravity : 0;
+        air[i] = moving & (hit[i] == 0);
+    }
+}
+
+void ItemStore::CollideWithCart(ItemStepInfo &info) {
+    int count = Size();
+    float *px = x.data(), *py = y.data(), *vy = yVel.data();
+    int *air = airborne.data(), *result = cartHit.data();
+    Rectangle cartRect = info.cartRect;
+    float width = itemTileSize - 2;
+    float height = itemTileSize;
+
+    // 1 = dropped inside the cart, 2 = clipped the rim and bounces back up
+    for (int i = 0; i < count; i++) {
+        float colX = px[i] + 1;
+        float colY = py[i] - itemTileSize;
+        int wasOverlapping = Overlaps(colX, colY - vy[i], width, height, cartRect);
+        int isOverlapping = Overlaps(colX, colY, width, height, cartRect);
+        int inside = (cartRect.x <= colX) & (colX + width < cartRect.x + cartRect.width);
+
+        int entered = air[i] & (wasOverlapping == 0) & isOverlapping;
+        result[i] = entered * (2 - inside);
+    }
+}
+
+void ItemStore::Steer(ItemStepInfo &info) {
+    int count = Size();
+    float *px = x.data(), *vx = xVel.data();
+    int *air = airborne.data();
+    float cartCenter = info.cartRect.x + info.cartRect.width / 2;
+    float nearDiminisher = info.magnet ? 0.005f : 0.01f;
+
+    for (int i = 0; i < count; i++) {
+        float movedX = px[i] + vx[i];
+        float difference = (movedX + itemTileSize / 2) - cartCenter;
+        int near = (difference <= 2) & (difference >= -2);
+        float diminisher = near ? nearDiminisher : 0.005f;
+
+        float v = vx[i];
+        float slowedRight = v - diminisher;
+        float slowedLeft = v + diminisher;
+        float slowed = v > 0 ? slowedRight : slowedLeft;
+        int stopped = (v < diminisher) & (v > -diminisher);
+        slowed = stopped ? 0 : slowed;
+
+        px[i] = air[i] ? movedX : px[i];
+        vx[i] = air[i] ? slowed : v;
+    }
+
+    if (info.magnet) {
+        PullTowardsCart(info);
+    }
+}
+
+void ItemStore::PullTowardsCart(ItemStepInfo &info) {
+    int count = Size();
+    float *px = x.data(), *vx = xVel.data();
+    int *air = airborne.data();
+    float cartCenter = info.cartRect.x + info.cartRect.width / 2;
+
+    for (int i = 0; i < count; i++) {
+        float difference = (px[i] + itemTileSize / 2) - cartCenter;
+        float v = vx[i];
+        float pulledRight = v + 0.015f > 0.6f ? 0.6f : v + 0.015f;
+        float pulledLeft = v - 0.015f < -0.6f ? -0.6f : v - 0.015f;
+        float pulled = difference > 2 ? pulledLeft : v;
+        pulled = difference < 2 ? pulledRight : pulled;
+
+        vx[i] = air[i] ? pulled : v;
+    }
+}
+
+void ItemStore::ApplyCartCollisions(ItemEvents &events) {
+    int count = Size();
+    for (int i = 0; i < count; i++) {
+        if (cartHit[i] == 1) {
+            insideCart[i] = true;
+            events.landedInCart.push_back(i);
+        } else if (cartHit[i] == 2) {
+            yVel[i] = -yVel[i];
+        }
+    }
+}
+
+void ItemStore::Rest(ItemEvents &events) {
+    int count = Size();
+    for (int i = 0; i < count; i++) {
+        if (insideCart[i] || yVel[i] != 0) continue;
+
+        x[i] = std::floor(x[i]);
+        y[i] = std::floor(y[i]);
+
+        lifetimes[i]++;
+        if (lifetimes[i] > itemLifetime) {
+            events.removed.push_back(i);
+        }
+    }
+}
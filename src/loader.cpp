@@ -0,0 +1,166 @@
+#include "loader.h"
+
+void AssetLoader::QueueImage(int group, const char *path, std::function<void(Image)> onLoaded) {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(Job {group, path, false, false, Image {}, Wave {}, onLoaded, nullptr});
+    pending.push_back((int) jobs.size() - 1);
+    remaining[group]++;
+    jobsChanged.notify_one();
+}
+
+void AssetLoader::QueueWave(int group, const char *path, std::function<void(Wave)> onLoaded) {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(Job {group, path, true, false, Image {}, Wave {}, nullptr, onLoaded});
+    pending.push_back((int) jobs.size() - 1);
+    remaining[group]++;
+    jobsChanged.notify_one();
+}
+
+void AssetLoader::UseBundle(AssetBundle *_bundle) {
+    bundle = _bundle;
+}
+
+void AssetLoader::Start() {
+#if !defined(PLATFORM_WEB)
+    int threads = (int) std::thread::hardware_concurrency() - 1;
+    if (threads < 1) threads = 1;
+    if (threads > maxLoaderThreads) threads = maxLoaderThreads;
+
+    for (int index = 0; index < threads; index++) {
+        workers.push_back(std::thread(&AssetLoader::WorkerLoop, this));
+    }
+#endif
+}
+
+void AssetLoader::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobsChanged.notify_all();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    // Anything decoded but never uploaded still owns its pixels or samples
+    for (int index : decoded) {
+        Release(jobs[index]);
+    }
+    decoded.clear();
+    pending.clear();
+}
+
+bool AssetLoader::Upload(float budget) {
+    double start = GetTime();
+    while (GetTime() - start < budget) {
+        if (!UploadNext(false)) break;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return uploaded == (int) jobs.size();
+}
+
+void AssetLoader::Finish(int group) {
+    while (!IsGroupDone(group)) {
+        if (!UploadNext(true)) break;
+    }
+}
+
+bool AssetLoader::IsGroupDone(int group) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return remaining[group] == 0;
+}
+
+float AssetLoader::Progress() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobs.empty()) return 1;
+    return (float) uploaded / jobs.size();
+}
+
+void AssetLoader::Decode(Job &job) {
+    const BundleEntry *entry = bundle ? bundle->Find(job.path) : nullptr;
+    if (entry) {
+        job.borrowed = true;
+        if (job.isWave)
+            job.wave = Wave {entry->frameCount, entry->sampleRate, entry->sampleSize, entry->channels, (void *) bundle->Data(entry)};
+        else
+            job.image = Image {(void *) bundle->Data(entry), entry->width, entry->height, 1, (int) entry->format};
+        return;
+    }
+
+    if (job.isWave)
+        job.wave = LoadWave(job.path);
+    else
+        job.image = LoadImage(job.path);
+}
+
+void AssetLoader::Complete(Job &job) {
+    if (job.isWave)
+        job.onWave(job.wave);
+    else
+        job.onImage(job.image);
+    Release(job);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    remaining[job.group]--;
+    uploaded++;
+}
+
+void AssetLoader::Release(Job &job) {
+    if (job.borrowed) return;
+
+    if (job.isWave)
+        UnloadWave(job.wave);
+    else
+        UnloadImage(job.image);
+}
+
+void AssetLoader::WorkerLoop() {
+    while (true) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobsChanged.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) return;
+
+            index = pending.front();
+            pending.pop_front();
+        }
+
+        Decode(jobs[index]);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(index);
+        }
+        jobsChanged.notify_all();
+    }
+}
+
+// Completes one decoded job, returns false when there was nothing to do
+bool AssetLoader::UploadNext(bool wait) {
+    int index = -1;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (wait && !workers.empty()) {
+            jobsChanged.wait(lock, [this] { return !decoded.empty() || (pending.empty() && uploaded + (int) decoded.size() == (int) jobs.size()); });
+        }
+
+        if (!decoded.empty()) {
+            index = decoded.front();
+            decoded.pop_front();
+        } else if (workers.empty() && !pending.empty()) {
+            // No worker threads, decode right here
+            index = pending.front();
+            pending.pop_front();
+            lock.unlock();
+            Decode(jobs[index]);
+        }
+    }
+
+    if (index == -1) return false;
+    Complete(jobs[index]);
+    return true;
+}
@@ -1,64 +1,126 @@
 #include "map.h"
-#include <sstream>
+#include "mapcache.h"
 #include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <thread>
 #include "utils.h"
 
-using namespace tinyxml2;
+#if defined(USE_ZSTD)
+    #include <zstd.h>
+#endif
 
-void ParseMapNode(Tilemap *map, XMLElement *element, std::function<Object(XMLElement *)> objectInitialiser);
-void ParseLayer(Tilemap *map, XMLElement *element);
-void ParseLayerData(Layer *layer, XMLElement *element);
-void ParseObjectLayer(Tilemap *map, XMLElement *element, std::function<Object(XMLElement *)> objectInitialiser);
-void ParseProperties(PropertyCollection *properties, XMLElement *element);
-Object ParseObject(XMLElement *element);
+// From sinfl.h, which raylib builds in for DecompressData but doesn't ship a header for
+extern "C" int sinflate(void *out, int cap, const void *in, int size);
+
+// Compressed layer data, inflated on a worker thread once the whole file is read
+struct LayerData {
+    Layer *layer;
+    std::string compression;
+    std::vector<unsigned char> bytes;
+    const char *error;
+};
+
+// Layer text arrives from the reader in pieces, so the decoders keep their state between pieces
+struct CsvDecoder {
+    std::vector<Tile> &tiles;
+    int count;
+    int index = 0;
+    unsigned int gid = 0;
+    bool inNumber = false;
+    bool overflow = false;
+
+    void Feed(const std::string &text);
+    bool Finish();
+};
+
+struct Base64Decoder {
+    std::vector<unsigned char> bytes;
+    unsigned int buffer = 0;
+    int pending = 0;
+    bool invalid = false;
+
+    void Feed(const std::string &text);
+    bool Finish();
+};
+
+void ParseMapNode(Tilemap *map, TmxReader &reader, std::function<Object(const TmxElement &, ObjectLayer &)> objectInitialiser);
+void ParseLayer(Tilemap *map, TmxReader &reader, std::vector<LayerData> &pending);
+void ParseLayerData(Layer *layer, TmxReader &reader, std::vector<LayerData> &pending);
+void ReportLayerError(Layer *layer, const char *error);
+void DecodeLayers(std::vector<LayerData> &pending);
+const char *BytesToTiles(const std::vector<unsigned char> &bytes, std::vector<Tile> &tiles, int count);
+bool Inflate(const std::vector<unsigned char> &data, const char *compression, std::vector<unsigned char> &bytes, int expectedSize);
+void ParseObjectLayer(Tilemap *map, TmxReader &reader, std::function<Object(const TmxElement &, ObjectLayer &)> objectInitialiser);
+void ParseProperties(PropertyCollection *properties, const TmxElement &element);
+Object ParseObject(const TmxElement &element, ObjectLayer &layer);
+Color ParseColor(const char *text, Color fallback);
+void DrawLayerTile(Tile *tile, int x, int y, TilesetCollection &tilesets, Vector2 tileSize, Camera2D camera, Vector2 offset, Color tint);
+void DrawFlippedTile(Texture2D image, Rectangle source, Rectangle dest, Tile tile, Color tint);
+void BakeChunk(Layer &layer, int chunkIndex, TilesetCollection &tilesets, Vector2 tileSize);
+void UnloadChunk(Layer &layer, int chunkIndex);
 
 Tileset LoadSet(const char* filename) {
+    if (IsMapCacheFresh(filename)) {
+        Tileset set;
+        if (LoadTilesetCache(MapCachePath(filename).c_str(), set)) return set;
+    }
+    return LoadSetSource(filename);
+}
+
+Tileset LoadSetSource(const char* filename) {
     Tileset set;
-    XMLDocument doc;
+    TmxReader reader;
 
-    if (doc.LoadFile(filename) != XML_SUCCESS) {
+    if (!reader.Open(filename) || !reader.FindElement("tileset")) {
         std::cout << "Error loading the file" << std::endl;
         return set;
     }
 
-    XMLElement *element = doc.FirstChildElement("tileset");
-    set.name = element->Attribute("name");
-    set.tileWidth = element->IntAttribute("tilewidth");
-    set.tileHeight = element->IntAttribute("tileheight");
-    set.tileCount = element->IntAttribute("tilecount");
+    TmxElement &element = reader.Element();
+    set.name = element.Attribute("name", "");
+    set.tileWidth = element.IntAttribute("tilewidth");
+    set.tileHeight = element.IntAttribute("tileheight");
+    set.tileCount = element.IntAttribute("tilecount");
 
-    set.width = element->IntAttribute("columns");
+    set.width = element.IntAttribute("columns");
     set.height = set.tileCount / set.width;
 
-    XMLElement *image = element->FirstChildElement("image");
-    if (image != NULL) {
-        set.path = image->Attribute("source");
-    }
-
-    ParseProperties(&set.properties, element->FirstChildElement("properties"));
-
-    for (XMLElement *tile = element->FirstChildElement("tile"); tile != NULL; tile = tile->NextSiblingElement("tile")) {
-        int id = tile->IntAttribute("id") + set.startingGid;
-        set.hitboxes[id] = std::vector<Rectangle>();
-        XMLElement *objectGroup = tile->FirstChildElement("objectgroup");
-        if (objectGroup != NULL) {
-            for (XMLElement *object = objectGroup->FirstChildElement("object"); object != NULL; object = object->NextSiblingElement("object")) {
-                if (object->Attribute("name") != NULL) continue;
-                set.hitboxes[id].push_back(Rectangle {
-                    object->FloatAttribute("x"),
-                    object->FloatAttribute("y"),
-                    object->FloatAttribute("width"),
-                    object->FloatAttribute("height")
-                });
+    int depth = reader.Depth();
+    while (reader.NextChild(depth)) {
+        if (reader.Element().name == "image") {
+            set.path = reader.Element().Attribute("source", "");
+        } else if (reader.Element().name == "properties") {
+            ParseProperties(&set.properties, reader.ReadElement());
+        } else if (reader.Element().name == "tile") {
+            TmxElement tile = reader.ReadElement();
+            int id = tile.IntAttribute("id") + set.startingGid;
+            set.hitboxes[id] = std::vector<Rectangle>();
+
+            const TmxElement *objectGroup = tile.FirstChild("objectgroup");
+            if (objectGroup != nullptr) {
+                for (const TmxElement &object : objectGroup->children) {
+                    if (object.name != "object" || object.Attribute("name") != nullptr) continue;
+                    set.hitboxes[id].push_back(Rectangle {
+                        object.FloatAttribute("x"),
+                        object.FloatAttribute("y"),
+                        object.FloatAttribute("width"),
+                        object.FloatAttribute("height")
+                    });
+                }
             }
-        }
-        XMLElement* el = tile->FirstChildElement("animation");
-        if (el != NULL) {
-            for (XMLElement *frame = el->FirstChildElement("frame"); frame != NULL; frame = frame->NextSiblingElement("frame")) {
-                set.animations[id].push_back(Frame {
-                    frame->IntAttribute("tileid") + 1,
-                    frame->IntAttribute("duration")
-                });
+
+            const TmxElement *animation = tile.FirstChild("animation");
+            if (animation != nullptr) {
+                for (const TmxElement &frame : animation->children) {
+                    if (frame.name != "frame") continue;
+                    set.animations[id].push_back(Frame {
+                        frame.IntAttribute("tileid") + 1,
+                        frame.IntAttribute("duration")
+                    });
+                }
             }
         }
     }
@@ -67,45 +129,56 @@ Tileset LoadSet(const char* filename) {
 }
 
 Tilemap LoadMap(const char* filename) {
+    if (IsMapCacheFresh(filename)) {
+        Tilemap map;
+        if (LoadMapCache(MapCachePath(filename).c_str(), map)) return map;
+    }
+	return LoadMap(filename, &ParseObject);
+}
+
+Tilemap LoadMapSource(const char* filename) {
 	return LoadMap(filename, &ParseObject);
 }
 
-Tilemap LoadMap(const char* filename, std::function<Object(XMLElement *)> objectInitialiser) {
+Tilemap LoadMap(const char* filename, std::function<Object(const TmxElement &, ObjectLayer &)> objectInitialiser) {
     Tilemap map;
-    XMLDocument doc;
+    TmxReader reader;
 
-    if (doc.LoadFile(filename) != XML_SUCCESS) {
+    if (!reader.Open(filename)) {
         std::cout << "Error loading the file" << std::endl;
         return map;
     }
 
-    ParseMapNode(&map, doc.FirstChildElement("map"), objectInitialiser);
+    ParseMapNode(&map, reader, objectInitialiser);
+    if (reader.Failed()) {
+        std::cout << "Malformed XML in " << filename << std::endl;
+    }
 	return map;
 }
 
-void ParseMapNode(Tilemap *map, XMLElement *element, std::function<Object(XMLElement *)> objectInitialiser) {
-    if (element == NULL) {
+void ParseMapNode(Tilemap *map, TmxReader &reader, std::function<Object(const TmxElement &, ObjectLayer &)> objectInitialiser) {
+    if (!reader.FindElement("map")) {
         std::cout << "No map node" << std::endl;
         return;
     }
 
-    map->tileWidth = element->IntAttribute("tilewidth");
-    map->tileHeight = element->IntAttribute("tileheight");
-    map->width = element->IntAttribute("width");
-    map->height = element->IntAttribute("height");
+    TmxElement &element = reader.Element();
+    map->tileWidth = element.IntAttribute("tilewidth");
+    map->tileHeight = element.IntAttribute("tileheight");
+    map->width = element.IntAttribute("width");
+    map->height = element.IntAttribute("height");
     map->rect = Rectangle {0, 0, (float) map->width * map->tileWidth, (float) map->height * map->tileHeight};
-	ParseProperties(&map->properties, element->FirstChildElement("properties"));
 
-    const char* orientation = element->Attribute("orientation");
-    if (strcmp(orientation, "isometric")) {
+    const char* orientation = element.Attribute("orientation", "");
+    if (strcmp(orientation, "isometric") == 0) {
         map->orientation = Orientation::Isometric;
-    } else if (strcmp(orientation, "orthagonal")) {
+    } else if (strcmp(orientation, "orthogonal") == 0) {
         map->orientation = Orientation::Orthogonal;
     } else {
         std::cout << "No orientation attribute" << std::endl;
     }
 
-    const char* renderOrder = element->Attribute("renderorder");
+    const char* renderOrder = element.Attribute("renderorder", "");
     if (strcmp(renderOrder, "left-down") == 0) {
         map->renderOrder = RenderOrder::LeftDown;
     } else if (strcmp(renderOrder, "left-up") == 0) {
@@ -117,125 +190,528 @@ void ParseMapNode(Tilemap *map, XMLElement *element, std::function<Object(XMLEle
     } else {
         std::cout << "No render order attribute" << std::endl;
     }
-    for (XMLElement *layer = element->FirstChildElement(); layer != NULL; layer = layer->NextSiblingElement()) {
-        if (strcmp(layer->Name(), "layer") == 0) {
-			ParseLayer(map, layer);
-		} else if (strcmp(layer->Name(), "objectgroup") == 0) {
-			ParseObjectLayer(map, layer, objectInitialiser);
+
+    std::vector<LayerData> pending;
+    int depth = reader.Depth();
+    while (reader.NextChild(depth)) {
+        if (reader.Element().name == "properties") {
+            ParseProperties(&map->properties, reader.ReadElement());
+        } else if (reader.Element().name == "layer") {
+			ParseLayer(map, reader, pending);
+		} else if (reader.Element().name == "objectgroup") {
+			ParseObjectLayer(map, reader, objectInitialiser);
 		}
     }
+    DecodeLayers(pending);
 }
 
-void ParseProperties(PropertyCollection *properties, XMLElement *element) {
-	if (element == NULL) {
-		return;
-	}
-	
-	for (XMLElement *xmlprop = element->FirstChildElement("property"); xmlprop != NULL; xmlprop = xmlprop->NextSiblingElement("property")) {
-        Property property;
-		property.name = xmlprop->Attribute("name");
-		property.value = xmlprop->Attribute("value");
-		property.type = xmlprop->Attribute("type") == NULL ? "string" : xmlprop->Attribute("type");
-		properties->properties.push_back(property);
+void ParseProperties(PropertyCollection *properties, const TmxElement &element) {
+	for (const TmxElement &xmlprop : element.children) {
+        if (xmlprop.name != "property") continue;
+
+        // Multi-line strings are stored as the element's text instead of a value
+		properties->AddProperty(xmlprop.Attribute("name", ""), xmlprop.Attribute("type", "string"), xmlprop.Attribute("value", xmlprop.text.c_str()));
     }
 }
 
-void ParseLayer(Tilemap *map, XMLElement *element) {
-    Layer &layer = map->layers[element->Attribute("name")];
+void ParseLayer(Tilemap *map, TmxReader &reader, std::vector<LayerData> &pending) {
+    TmxElement &element = reader.Element();
+    Layer &layer = map->layers[element.Attribute("name", "")];
 
-    layer.name = element->Attribute("name");
-    layer.id = element->IntAttribute("id");
-    layer.width = element->IntAttribute("width");
-    layer.height = element->IntAttribute("height");
+    layer.name = element.Attribute("name", "");
+    layer.id = element.IntAttribute("id");
+    layer.width = element.IntAttribute("width");
+    layer.height = element.IntAttribute("height");
+    layer.opacity = element.FloatAttribute("opacity", 1);
+    layer.visible = element.IntAttribute("visible", 1) == 1;
 
-    if (element->Attribute("opacity"))
-        layer.opacity = element->FloatAttribute("opacity");
-    else {
-        layer.opacity = 1;
-	}
-    if (element->Attribute("visible"))
-        layer.visible = (element->IntAttribute("visible") == 1 ? true : false);
-    else {
-        layer.visible = true;
-	}
-    
-	ParseProperties(&map->properties, element->FirstChildElement("properties"));
-    ParseLayerData(&layer, element->FirstChildElement("data"));
+    bool hasData = false;
+    int depth = reader.Depth();
+    while (reader.NextChild(depth)) {
+        if (reader.Element().name == "properties") {
+            ParseProperties(&map->properties, reader.ReadElement());
+        } else if (reader.Element().name == "data") {
+            ParseLayerData(&layer, reader, pending);
+            hasData = true;
+        }
+    }
+
+    if (!hasData) {
+        std::cout << "No data element" << std::endl;
+    }
 
+    layer.InitChunks();
     map->layerNames.push_back(layer.name);
 }
 
-void ParseLayerData(Layer *layer, XMLElement *element) {
-    if (element == NULL) {
-        std::cout << "No data element" << std::endl;
-        return;
+// Csv and uncompressed base64 go straight into the layer as the text streams in,
+// compressed layers are only base64 decoded here and inflated in DecodeLayers
+void ParseLayerData(Layer *layer, TmxReader &reader, std::vector<LayerData> &pending) {
+    std::string encoding = reader.Element().Attribute("encoding", "");
+    std::string compression = reader.Element().Attribute("compression", "");
+    int count = layer->width * layer->height;
+    int depth = reader.Depth();
+
+    if (encoding == "csv") {
+        layer->tiles.resize(count);
+        CsvDecoder decoder {layer->tiles, count};
+        while (reader.Next() == TmxReader::Text) {
+            decoder.Feed(reader.GetText());
+        }
+        if (!decoder.Finish()) ReportLayerError(layer, "Wrong number of tiles in the csv data");
+    } else if (encoding == "base64") {
+        Base64Decoder decoder;
+        decoder.bytes.reserve(compression.empty() ? count * 4 : 0);
+        while (reader.Next() == TmxReader::Text) {
+            decoder.Feed(reader.GetText());
+        }
+
+        if (!decoder.Finish()) {
+            ReportLayerError(layer, "Invalid base64 data");
+        } else if (!compression.empty()) {
+            pending.push_back(LayerData {layer, compression, std::move(decoder.bytes), nullptr});
+        } else {
+            ReportLayerError(layer, BytesToTiles(decoder.bytes, layer->tiles, count));
+        }
+    } else if (encoding.empty()) {
+        // One <tile gid=""/> element per tile
+        layer->tiles.reserve(count);
+        while (reader.NextChild(depth)) {
+            if (reader.Element().name != "tile") continue;
+            layer->tiles.push_back(Tile {(unsigned int) strtoul(reader.Element().Attribute("gid", "0"), nullptr, 10)});
+        }
+        if ((int) layer->tiles.size() != count) ReportLayerError(layer, "Wrong number of tiles in the layer");
+    } else {
+        ReportLayerError(layer, "Unknown encoding");
     }
+}
 
-	const char* encoding = element->Attribute("encoding");
+void ReportLayerError(Layer *layer, const char *error) {
+    if (error == nullptr) return;
+    std::cout << "Layer " << layer->name << ": " << error << std::endl;
+    layer->tiles.clear();
+}
 
-	if (strcmp(encoding, "csv") == 0)
-	{
-		std::stringstream csvss (element->FirstChild()->Value());
+int layerDecodeThreads = 0;
 
-		int gid = 0;
-		while (csvss >> gid)
-		{
-			if (csvss.peek() == ',' || csvss.peek() == '\n')
-			{
-				csvss.ignore();
-			}
+// Every compressed layer gets its own thread up to layerDecodeThreads, the web build inflates them in turn
+void DecodeLayers(std::vector<LayerData> &pending) {
+    auto work = [&pending](std::atomic<int> *next) {
+        for (int index = (*next)++; index < (int) pending.size(); index = (*next)++) {
+            LayerData &data = pending[index];
+            int count = data.layer->width * data.layer->height;
 
-			layer->tiles.push_back(Tile {gid});
-		}
-	}
+            std::vector<unsigned char> inflated;
+            if (Inflate(data.bytes, data.compression.c_str(), inflated, count * 4))
+                data.error = BytesToTiles(inflated, data.layer->tiles, count);
+            else
+                data.error = "Couldn't decompress the layer data";
+            std::vector<unsigned char>().swap(data.bytes);
+        }
+    };
+
+    std::atomic<int> next {0};
+#if defined(PLATFORM_WEB)
+    work(&next);
+#else
+    int threads = layerDecodeThreads > 0 ? layerDecodeThreads : (int) std::thread::hardware_concurrency();
+    threads = std::min(threads, (int) pending.size());
+    std::vector<std::thread> workers;
+    for (int index = 1; index < threads; index++) {
+        workers.push_back(std::thread(work, &next));
+    }
+    work(&next);
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+#endif
+
+    for (LayerData &data : pending) {
+        ReportLayerError(data.layer, data.error);
+    }
 }
 
-void ParseObjectLayer(Tilemap *map, XMLElement *element, std::function<Object(XMLElement *)> objectInitialiser) {
-	ObjectLayer &layer = map->objectLayers[element->Attribute("name")];
+// Gids are stored as little endian 32 bit integers, returns what went wrong or nullptr
+const char *BytesToTiles(const std::vector<unsigned char> &bytes, std::vector<Tile> &tiles, int count) {
+    if ((int) bytes.size() != count * 4) return "Wrong number of tiles in the base64 data";
 
-	layer.id = element->IntAttribute("id");
-	layer.name = element->Attribute("name");
+    tiles.resize(count);
+    const unsigned char *byte = bytes.data();
+    for (int index = 0; index < count; index++, byte += 4) {
+        unsigned int gid = byte[0] | byte[1] << 8 | byte[2] << 16 | (unsigned int) byte[3] << 24;
+        tiles[index] = Tile {gid};
+    }
+    return nullptr;
+}
 
-	ParseProperties(&layer.properties, element->FirstChildElement("properties"));
+void CsvDecoder::Feed(const std::string &text) {
+    for (char character : text) {
+        if (character >= '0' && character <= '9') {
+            gid = gid * 10 + (character - '0');
+            inNumber = true;
+            continue;
+        }
+        if (!inNumber) continue;
 
-	for (XMLElement *object = element->FirstChildElement("object"); object != NULL; object = object->NextSiblingElement("object")) {
-		layer.objects[object->Attribute("name")].push_back(ParseObject(object));
-	}
+        if (index == count)
+            overflow = true;
+        else
+            tiles[index++] = Tile {gid};
+        gid = 0;
+        inNumber = false;
+    }
+}
+
+bool CsvDecoder::Finish() {
+    Feed(",");
+    return !overflow && index == count;
 }
 
-Object ParseObject(XMLElement *element) {
-    if (!element->NoChildren()) {
-        if (strcmp(element->FirstChildElement()->Name(), "text")) {
-            TextObject object;
-            XMLElement* textElement = element->FirstChildElement("text");
-            object.wrap = textElement->BoolAttribute("wrap", false);
-            object.bold = textElement->BoolAttribute("bold", false);
-            object.italic = textElement->BoolAttribute("italic", false);
-            object.underline = textElement->BoolAttribute("underline", false);
-            object.strikeout = textElement->BoolAttribute("strikeout", false);
-            object.kerning = textElement->BoolAttribute("kerning", false);
-            object.fontSize = textElement->IntAttribute("fontsize", 16);
-            object.fontFamily = textElement->Attribute("fontfamily", "Arial");
-            object.verticalAlignment = textElement->Attribute("verticalalignment", "top");
-            object.horizontalAlignment = textElement->Attribute("horizontalalignment", "left");
-            object.text = textElement->GetText();
-            return object;
+// Tiled wraps the base64 text in whitespace, which is skipped along with the padding
+void Base64Decoder::Feed(const std::string &text) {
+    static const std::array<signed char, 256> values = [] {
+        std::array<signed char, 256> values;
+        values.fill(-1);
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int index = 0; index < 64; index++) {
+            values[(unsigned char) alphabet[index]] = (signed char) index;
+        }
+        return values;
+    }();
+
+    size_t start = bytes.size();
+    bytes.resize(start + text.size() / 4 * 3 + 3);
+    unsigned char *out = bytes.data() + start;
+
+    for (unsigned char character : text) {
+        int value = values[character];
+        if (value < 0) {
+            if (character == '=' || isspace(character)) continue;
+            invalid = true;
+            break;
+        }
+
+        buffer = buffer << 6 | value;
+        if (++pending == 4) {
+            out[0] = (unsigned char) (buffer >> 16);
+            out[1] = (unsigned char) (buffer >> 8);
+            out[2] = (unsigned char) buffer;
+            out += 3;
+            buffer = 0;
+            pending = 0;
         }
     }
 
+    bytes.resize(out - bytes.data());
+}
+
+// Two or three leftover characters hold one or two bytes
+bool Base64Decoder::Finish() {
+    if (invalid || pending == 1) return false;
+    if (pending >= 2) bytes.push_back((unsigned char) (buffer >> (pending == 2 ? 4 : 10)));
+    if (pending == 3) bytes.push_back((unsigned char) (buffer >> 2));
+    return true;
+}
+
+// zlib and gzip are both a header around a deflate stream, raylib inflates the stream itself
+bool Inflate(const std::vector<unsigned char> &data, const char *compression, std::vector<unsigned char> &bytes, int expectedSize) {
+    int size = (int) data.size();
+    int start = 0;
+    int end = size;
+
+    if (strcmp(compression, "zlib") == 0) {
+        // Compression method 8 and no preset dictionary, then adler32 at the end
+        if (size < 6 || (data[0] & 0x0f) != 8 || (data[0] << 8 | data[1]) % 31 != 0 || (data[1] & 0x20)) return false;
+        start = 2;
+        end = size - 4;
+    } else if (strcmp(compression, "gzip") == 0) {
+        if (size < 18 || data[0] != 0x1f || data[1] != 0x8b || data[2] != 8) return false;
+        int flags = data[3];
+        start = 10;
+        if (flags & 0x04) start += 2 + (data[start] | data[start + 1] << 8);
+        if (flags & 0x08) while (start < size && data[start++] != 0);
+        if (flags & 0x10) while (start < size && data[start++] != 0);
+        if (flags & 0x02) start += 2;
+        end = size - 8;
+
+        // The trailer ends with the inflated size
+        unsigned int inflatedSize = data[size - 4] | data[size - 3] << 8 | data[size - 2] << 16 | (unsigned int) data[size - 1] << 24;
+        if (inflatedSize != (unsigned int) expectedSize) return false;
+    } else if (strcmp(compression, "zstd") == 0) {
+#if defined(USE_ZSTD)
+        bytes.resize(expectedSize);
+        size_t written = ZSTD_decompress(bytes.data(), bytes.size(), data.data(), data.size());
+        return !ZSTD_isError(written) && (int) written == expectedSize;
+#else
+        std::cout << "Build with -DUSE_ZSTD and link zstd to load zstd compressed layers" << std::endl;
+        return false;
+#endif
+    } else {
+        return false;
+    }
+
+    if (start >= end) return false;
+
+    // Straight into a buffer of the layer's size, DecompressData would allocate a fixed 64 MiB
+    // every call and cap the layer there. A longer stream stops at the end of the buffer
+    bytes.resize(expectedSize);
+    int inflatedSize = sinflate(bytes.data(), expectedSize, data.data() + start, end - start);
+    return inflatedSize == expectedSize;
+}
+
+void ParseObjectLayer(Tilemap *map, TmxReader &reader, std::function<Object(const TmxElement &, ObjectLayer &)> objectInitialiser) {
+    TmxElement &element = reader.Element();
+	ObjectLayer &layer = map->objectLayers[element.Attribute("name", "")];
+
+	layer.id = element.IntAttribute("id");
+	layer.name = element.Attribute("name", "");
+
+    int depth = reader.Depth();
+    while (reader.NextChild(depth)) {
+        if (reader.Element().name == "properties") {
+            ParseProperties(&layer.properties, reader.ReadElement());
+        } else if (reader.Element().name == "object") {
+            // Only one object is ever held as a tree
+            TmxElement object = reader.ReadElement();
+            layer.Add(objectInitialiser(object, layer));
+        }
+	}
+}
+
+Object ParseObject(const TmxElement &element, ObjectLayer &layer) {
     Object object;
-    object.id = element->IntAttribute("id");
-    object.name = element->Attribute("name");
+    object.id = element.IntAttribute("id");
+    object.name = element.Attribute("name", "");
     object.rect = {
-        element->FloatAttribute("x"), 
-        element->FloatAttribute("y"), 
-        element->FloatAttribute("width"), 
-        element->FloatAttribute("height")
+        element.FloatAttribute("x"), 
+        element.FloatAttribute("y"), 
+        element.FloatAttribute("width"), 
+        element.FloatAttribute("height")
     };
 
+    const TmxElement *properties = element.FirstChild("properties");
+    if (properties != nullptr) ParseProperties(&object.properties, *properties);
+
+    const TmxElement *textElement = element.FirstChild("text");
+    if (element.FirstChild("point") != nullptr) {
+        object.shape = PointShape;
+    } else if (element.FirstChild("ellipse") != nullptr) {
+        object.shape = EllipseShape;
+    } else if (textElement != nullptr) {
+        TextObject text;
+        text.textColor = ParseColor(textElement->Attribute("color", nullptr), BLACK);
+        text.wrap = textElement->BoolAttribute("wrap", false);
+        text.bold = textElement->BoolAttribute("bold", false);
+        text.italic = textElement->BoolAttribute("italic", false);
+        text.underline = textElement->BoolAttribute("underline", false);
+        text.strikeout = textElement->BoolAttribute("strikeout", false);
+        text.kerning = textElement->BoolAttribute("kerning", true);
+        text.fontSize = textElement->IntAttribute("pixelsize", 16);
+        text.fontFamily = textElement->Attribute("fontfamily", "sans-serif");
+        text.verticalAlignment = textElement->Attribute("valign", "top");
+        text.horizontalAlignment = textElement->Attribute("halign", "left");
+        text.text = textElement->text;
+
+        object.shape = TextShape;
+        object.text = (int) layer.texts.size();
+        layer.texts.push_back(text);
+    }
+
     return object;
 }
 
+// Tiled writes colors as "#RRGGBB" or "#AARRGGBB"
+Color ParseColor(const char *text, Color fallback) {
+    if (text == nullptr) return fallback;
+    if (text[0] == '#') text++;
+
+    size_t length = strlen(text);
+    if (length != 6 && length != 8) return fallback;
+
+    unsigned int value = (unsigned int) strtoul(text, nullptr, 16);
+    unsigned char alpha = length == 8 ? (value >> 24) & 0xff : 255;
+    return Color {(unsigned char) ((value >> 16) & 0xff), (unsigned char) ((value >> 8) & 0xff), (unsigned char) (value & 0xff), alpha};
+}
+
+// Maps only intern while loading, but nothing stops a worker thread from loading one
+std::mutex propertyNamesMutex;
+std::unordered_map<std::string, int> propertyKeys;
+std::deque<std::string> propertyNames;      // A deque so names handed out by PropertyName never move
+
+int InternProperty(const std::string &name) {
+    std::lock_guard<std::mutex> lock(propertyNamesMutex);
+    auto found = propertyKeys.find(name);
+    if (found != propertyKeys.end()) return found->second;
+
+    propertyNames.push_back(name);
+    propertyKeys[name] = (int) propertyNames.size() - 1;
+    return (int) propertyNames.size() - 1;
+}
+
+int FindProperty(const char *name) {
+    std::lock_guard<std::mutex> lock(propertyNamesMutex);
+    auto found = propertyKeys.find(name);
+    return found == propertyKeys.end() ? -1 : found->second;
+}
+
+const std::string &PropertyName(int key) {
+    static const std::string unknown;
+    std::lock_guard<std::mutex> lock(propertyNamesMutex);
+    if (key < 0 || key >= (int) propertyNames.size()) return unknown;
+    return propertyNames[key];
+}
+
+void PropertyCollection::Add(const Property &property) {
+    auto found = std::lower_bound(properties.begin(), properties.end(), property.key, [](const Property &property, int key) {
+        return property.key < key;
+    });
+    if (found != properties.end() && found->key == property.key)
+        *found = property;
+    else
+        properties.insert(found, property);
+}
+
+void PropertyCollection::AddProperty(const std::string &name, const std::string &type, const std::string &value) {
+    Property property;
+    property.key = InternProperty(name);
+
+    if (type == "int") {
+        property.type = IntProperty;
+        property.intValue = atoi(value.c_str());
+    } else if (type == "object") {
+        property.type = ObjectProperty;
+        property.intValue = atoi(value.c_str());
+    } else if (type == "float") {
+        property.type = FloatProperty;
+        property.floatValue = (float) atof(value.c_str());
+    } else if (type == "bool") {
+        property.type = BoolProperty;
+        property.boolValue = value == "true";
+    } else if (type == "color") {
+        // An unset color is written as an empty value
+        property.type = ColorProperty;
+        property.colorValue = ParseColor(value.c_str(), BLANK);
+    } else {
+        property.type = type == "file" ? FileProperty : StringProperty;
+        property.text = value;
+    }
+    Add(property);
+}
+
+void ObjectGrid::Build(const std::vector<Object> &objects) {
+    bounds.clear();
+    entries.clear();
+    cellStarts.clear();
+    seen.assign(objects.size(), 0);
+    stamp = 0;
+    cellsX = cellsY = 0;
+    if (objects.empty()) return;
+
+    Vector2 end = {objects[0].rect.x, objects[0].rect.y};
+    origin = end;
+    for (const Object &object : objects) {
+        bounds.push_back(object.rect);
+        origin.x = std::min(origin.x, object.rect.x);
+        origin.y = std::min(origin.y, object.rect.y);
+        end.x = std::max(end.x, object.rect.x + object.rect.width);
+        end.y = std::max(end.y, object.rect.y + object.rect.height);
+    }
+
+    // A few big objects spread over a large map would otherwise leave nearly every cell empty
+    cellSize = objectCellSize;
+    while (true) {
+        cellsX = (int) ((end.x - origin.x) / cellSize) + 1;
+        cellsY = (int) ((end.y - origin.y) / cellSize) + 1;
+        if ((size_t) cellsX * cellsY <= objects.size() * 4 + 64) break;
+        cellSize *= 2;
+    }
+
+    // Counted first so every cell's list can be packed into entries without reallocating
+    auto cellRange = [this](Rectangle rect, int &left, int &top, int &right, int &bottom) {
+        left = std::clamp((int) ((rect.x - origin.x) / cellSize), 0, cellsX - 1);
+        top = std::clamp((int) ((rect.y - origin.y) / cellSize), 0, cellsY - 1);
+        right = std::clamp((int) ((rect.x + rect.width - origin.x) / cellSize), 0, cellsX - 1);
+        bottom = std::clamp((int) ((rect.y + rect.height - origin.y) / cellSize), 0, cellsY - 1);
+    };
+
+    cellStarts.assign(cellsX * cellsY + 1, 0);
+    int left, top, right, bottom;
+    for (const Rectangle &rect : bounds) {
+        cellRange(rect, left, top, right, bottom);
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                cellStarts[y * cellsX + x + 1]++;
+            }
+        }
+    }
+    for (int cell = 0; cell < cellsX * cellsY; cell++) {
+        cellStarts[cell + 1] += cellStarts[cell];
+    }
+
+    entries.resize(cellStarts.back());
+    std::vector<int> filled(cellStarts.begin(), cellStarts.end() - 1);
+    for (int index = 0; index < (int) bounds.size(); index++) {
+        cellRange(bounds[index], left, top, right, bottom);
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                entries[filled[y * cellsX + x]++] = index;
+            }
+        }
+    }
+}
+
+void ObjectGrid::Query(Rectangle area, std::vector<int> &found) {
+    if (cellsX == 0) return;
+
+    int left = (int) floorf((area.x - origin.x) / cellSize);
+    int top = (int) floorf((area.y - origin.y) / cellSize);
+    int right = (int) floorf((area.x + area.width - origin.x) / cellSize);
+    int bottom = (int) floorf((area.y + area.height - origin.y) / cellSize);
+    if (right < 0 || bottom < 0 || left >= cellsX || top >= cellsY) return;
+
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, cellsX - 1);
+    bottom = std::min(bottom, cellsY - 1);
+
+    if (++stamp == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        stamp = 1;
+    }
+
+    for (int y = top; y <= bottom; y++) {
+        for (int x = left; x <= right; x++) {
+            int cell = y * cellsX + x;
+            for (int entry = cellStarts[cell]; entry < cellStarts[cell + 1]; entry++) {
+                int index = entries[entry];
+                if (seen[index] == stamp) continue;
+                seen[index] = stamp;
+
+                Rectangle &rect = bounds[index];
+                if (rect.x <= area.x + area.width && rect.x + rect.width >= area.x
+                    && rect.y <= area.y + area.height && rect.y + rect.height >= area.y) {
+                    found.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+void ObjectLayer::Query(Rectangle area, std::vector<Object*> &found) {
+    if (!indexed) {
+        grid.Build(objects);
+        indexed = true;
+    }
+
+    queryIndices.clear();
+    grid.Query(area, queryIndices);
+    std::sort(queryIndices.begin(), queryIndices.end());
+    for (int index : queryIndices) {
+        found.push_back(&objects[index]);
+    }
+}
+
 void TilesetCollection::AddTileset(const char* path, Texture2D image) {
     Tileset tileset = LoadSet(path);
     tileset.image = image;
@@ -246,6 +722,7 @@ void TilesetCollection::AddTileset(const char* path, Texture2D image) {
     }
 
     tileset.startingGid = startingGid;
+    AddTiles(tileset);
     tilesets.emplace_back(tileset);
 }
 
@@ -264,13 +741,66 @@ void TilesetCollection::AddTileset(Texture2D image, int tileWidth, int tileHeigh
     }
 
     tileset.startingGid = startingGid;
+    AddTiles(tileset);
     tilesets.emplace_back(tileset);
 }
 
+// Fills the gid table for a tileset that is about to be appended. Animations and
+// hitboxes are parsed with local ids + 1, so they shift by the starting gid - 1
+void TilesetCollection::AddTiles(Tileset &tileset) {
+    if (tiles.empty()) tiles.push_back(TileInfo {});
+    tiles.resize(tileset.startingGid + tileset.tileCount);
+
+    int tilesetIndex = (int) tilesets.size();
+    for (int gid = tileset.startingGid; gid < tileset.startingGid + tileset.tileCount; gid++) {
+        tiles[gid] = TileInfo {tileset.image, tileset.GetSourceRect(gid), tilesetIndex};
+    }
+
+    for (auto &[id, frames] : tileset.animations) {
+        if (frames.empty()) continue;
+
+        AnimationClip clip;
+        int total = 0;
+        for (Frame &frame : frames) {
+            total += frame.duration;
+            clip.gids.push_back(frame.gid + tileset.startingGid - 1);
+            clip.frameEnds.push_back(total);
+        }
+        clip.currentGid = clip.gids[0];
+
+        tiles[id + tileset.startingGid - 1].clip = (int) clips.size();
+        clips.push_back(clip);
+    }
+
+    for (auto &[id, rects] : tileset.hitboxes) {
+        TileInfo &tile = tiles[id + tileset.startingGid - 1];
+        tile.hitboxStart = (int) hitboxRects.size();
+        tile.hitboxCount = (int) rects.size();
+        hitboxRects.insert(hitboxRects.end(), rects.begin(), rects.end());
+    }
+
+    tileCount = (int) tiles.size() - 1;
+}
+
+void TilesetCollection::Animate(double time) {
+    long long milliseconds = (long long) (time * 1000);
+    for (AnimationClip &clip : clips) {
+        int total = clip.frameEnds.back();
+        if (total <= 0) continue;
+
+        int time = (int) (milliseconds % total);
+        int frame = std::upper_bound(clip.frameEnds.begin(), clip.frameEnds.end(), time) - clip.frameEnds.begin();
+        clip.currentGid = clip.gids[frame];
+    }
+}
+
 void Tilemap::Clear() {
+    UnloadChunks();
     for (auto &[num, layer] : layers) {
         layer.tiles.clear();
+        layer.stream = nullptr;
     }
+    stream.reset();
     for (auto &[num, layer] : objectLayers) {
         layer.objects.clear();
     }
@@ -315,97 +845,404 @@ void Tilemap::DrawLayer(std::string layerName, TilesetCollection &tilesets, Came
 }
 
 void Tilemap::DrawLayer(std::string layerName, TilesetCollection &tilesets, Camera2D camera, Rectangle area, Vector2 offset, Color tint) {
-    if (layers.find(layerName) == layers.end()) return;
-    
-    Layer &layer = layers[layerName];
-    for (int x = area.x; x < area.width; x++) {
-        for (int y = area.y; y < area.height; y++) {
-            Tile* tile = layer.Getat({(float) x, (float) y});
-            if (tile->gid == 0) continue;
-
-            Tileset* tileset = tilesets.Get(tile->gid);
-            if (tileset != nullptr) {
-                int gid = tile->gid;
-
-                // Animation
-                if (tileset->animations.find(gid) != tileset->animations.end()) {
-                    tile->animationIndex += 1;
-                    int sum = 0;
-                    for (Frame frame : tileset->animations.at(gid)) {
-                        sum += ((float) frame.duration / 1000) * GetFPS();
-                        if (sum > tile->animationIndex) {
-                            gid = frame.gid;
-                            break;
-                        }
-                    }
-                    if (sum <= tile->animationIndex) {
-                        tile->animationIndex = 0;
-                        gid = tileset->animations[gid][0].gid;
+    auto layer = layers.find(layerName);
+    if (layer == layers.end()) return;
+    DrawLayer(layer->second, tilesets, camera, area, offset, tint);
+}
+
+void Tilemap::DrawLayer(Layer &layer, TilesetCollection &tilesets, Camera2D camera, Rectangle area, Vector2 offset, Color tint) {
+    Vector2 tileSize = {(float) tileWidth, (float) tileHeight};
+
+    int firstChunkX = (int) area.x / chunkSize;
+    int firstChunkY = (int) area.y / chunkSize;
+    int lastChunkX = ((int) area.width - 1) / chunkSize;
+    int lastChunkY = ((int) area.height - 1) / chunkSize;
+
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY && chunkY < layer.chunksY; chunkY++) {
+        for (int chunkX = firstChunkX; chunkX <= lastChunkX && chunkX < layer.chunksX; chunkX++) {
+            TileChunk &chunk = layer.chunks[chunkY * layer.chunksX + chunkX];
+
+            // Part of the chunk inside the area, in tiles
+            int startX = std::max(chunkX * chunkSize, (int) area.x);
+            int startY = std::max(chunkY * chunkSize, (int) area.y);
+            int endX = std::min({(chunkX + 1) * chunkSize, (int) area.width, layer.width});
+            int endY = std::min({(chunkY + 1) * chunkSize, (int) area.height, layer.height});
+            if (startX >= endX || startY >= endY) continue;
+
+            if (!chunk.resident || chunk.dirty) {
+                for (int x = startX; x < endX; x++) {
+                    for (int y = startY; y < endY; y++) {
+                        DrawLayerTile(layer.Getat({(float) x, (float) y}), x, y, tilesets, tileSize, camera, offset, tint);
                     }
                 }
+                continue;
+            }
 
-                Rectangle source = tileset->GetSourceRect(gid);
-                Rectangle dest = {
-                    (x * tileWidth - camera.offset.x) * camera.zoom + offset.x, 
-                    (y * tileHeight - camera.offset.y) * camera.zoom + offset.y, 
-                    tileWidth * camera.zoom, 
-                    tileHeight * camera.zoom
-                };
-                DrawTexturePro(tileset->image, source, dest, Vector2 {0, 0}, 0, tint);
+            // Render textures are stored upside down
+            float textureHeight = (float) chunk.texture.texture.height;
+            Rectangle source = {
+                (float) (startX - chunkX * chunkSize) * tileWidth,
+                textureHeight - (endY - chunkY * chunkSize) * tileHeight,
+                (float) (endX - startX) * tileWidth,
+                (float) -(endY - startY) * tileHeight
+            };
+            Rectangle dest = {
+                (startX * tileWidth - camera.offset.x) * camera.zoom + offset.x,
+                (startY * tileHeight - camera.offset.y) * camera.zoom + offset.y,
+                (endX - startX) * tileWidth * camera.zoom,
+                (endY - startY) * tileHeight * camera.zoom
+            };
+            DrawTexturePro(chunk.texture.texture, source, dest, Vector2 {0, 0}, 0, tint);
+
+            for (int index : chunk.animatedTiles) {
+                int x = index % layer.width;
+                int y = index / layer.width;
+                if (x < startX || x >= endX || y < startY || y >= endY) continue;
+                DrawLayerTile(layer.Getat(Vector2 {(float) x, (float) y}), x, y, tilesets, tileSize, camera, offset, tint);
             }
         }
     }
 }
 
-void DrawTile(int gid, Vector2 pos, TilesetCollection &tilesets, Camera2D cam, Color tint, bool flippedX, bool flippedY) {
-    if (gid == 0) return;
+void DrawLayerTile(Tile *tile, int x, int y, TilesetCollection &tilesets, Vector2 tileSize, Camera2D camera, Vector2 offset, Color tint) {
+    if (tile == nullptr || tile->Gid() == 0) return;
 
-    Tileset* tileset = tilesets.Get(gid);
-    if (tileset != nullptr) {
-        Rectangle source = tileset->GetSourceRect(gid);
-        Rectangle dest = {
-            (pos.x - cam.offset.x) * cam.zoom, 
-            (pos.y - cam.offset.y) * cam.zoom, 
-            tileset->tileWidth * cam.zoom, 
-            tileset->tileHeight * cam.zoom
-        };
-        if (!CheckCollisionRecs(dest, Rectangle {0, 0, (float) GetScreenWidth(), (float) GetScreenHeight()})) return;
+    TileInfo &info = tilesets.GetTile(tilesets.GetFrameGid(tile->Gid()));
+    if (info.tileset < 0) return;
 
-        if (flippedX) {
-            source = Rectangle {source.x, source.y, -source.width, source.height};
-        }
-        if (flippedY) {
-            source = Rectangle {source.x, source.y, source.width, -source.height};
+    Rectangle dest = {
+        (x * tileSize.x - camera.offset.x) * camera.zoom + offset.x, 
+        (y * tileSize.y - camera.offset.y) * camera.zoom + offset.y, 
+        tileSize.x * camera.zoom, 
+        tileSize.y * camera.zoom
+    };
+    DrawFlippedTile(info.image, info.source, dest, *tile, tint);
+}
+
+// Tiled flips diagonally first, then horizontally, then vertically. The diagonal flip is a
+// quarter turn clockwise of a vertically flipped source, and after that turn the horizontal
+// and vertical flips land on the other axis of the source
+void DrawFlippedTile(Texture2D image, Rectangle source, Rectangle dest, Tile tile, Color tint) {
+    if ((tile.cell & ~gidMask) == 0) {
+        DrawTexturePro(image, source, dest, Vector2 {0, 0}, 0, tint);
+        return;
+    }
+
+    bool flipX = tile.FlippedX();
+    bool flipY = tile.FlippedY();
+    float rotation = 0;
+    if (tile.FlippedDiagonally()) {
+        flipX = tile.FlippedY();
+        flipY = !tile.FlippedX();
+        rotation = 90;
+    }
+
+    if (flipX) source.width = -source.width;
+    if (flipY) source.height = -source.height;
+
+    // Turn around the middle of the tile so it stays in its cell
+    Vector2 origin = {dest.width / 2, dest.height / 2};
+    dest.x += origin.x;
+    dest.y += origin.y;
+    DrawTexturePro(image, source, dest, origin, rotation, tint);
+}
+
+void Tilemap::RefreshChunks(TilesetCollection &tilesets, Camera2D camera) {
+    chunkFrame++;
+    Rectangle area = GetArea(camera, tileWidth, tileHeight);
+    Vector2 tileSize = {(float) tileWidth, (float) tileHeight};
+
+    for (auto &[name, layer] : layers) {
+        if (layer.chunks.empty()) continue;
+
+        int lastChunkX = std::min(((int) area.width - 1) / chunkSize, layer.chunksX - 1);
+        int lastChunkY = std::min(((int) area.height - 1) / chunkSize, layer.chunksY - 1);
+
+        for (int chunkY = (int) area.y / chunkSize; chunkY <= lastChunkY; chunkY++) {
+            for (int chunkX = (int) area.x / chunkSize; chunkX <= lastChunkX; chunkX++) {
+                int chunkIndex = chunkY * layer.chunksX + chunkX;
+                TileChunk &chunk = layer.chunks[chunkIndex];
+
+                if (!chunk.resident) {
+                    chunk.texture = LoadRenderTexture(chunkSize * tileWidth, chunkSize * tileHeight);
+                    chunk.resident = true;
+                    chunk.dirty = true;
+                    layer.residentChunks.push_back(chunkIndex);
+                }
+                if (chunk.dirty) BakeChunk(layer, chunkIndex, tilesets, tileSize);
+                chunk.lastUsed = chunkFrame;
+            }
         }
 
-        DrawTexturePro(tileset->image, source, dest, Vector2 {0, 0}, 0, tint);
+        // Drop the chunks that went unseen the longest
+        if ((int) layer.residentChunks.size() > maxResidentChunks) {
+            std::sort(layer.residentChunks.begin(), layer.residentChunks.end(), [&layer](int a, int b) {
+                return layer.chunks[a].lastUsed > layer.chunks[b].lastUsed;
+            });
+            while ((int) layer.residentChunks.size() > maxResidentChunks && layer.chunks[layer.residentChunks.back()].lastUsed != chunkFrame) {
+                UnloadChunk(layer, layer.residentChunks.back());
+                layer.residentChunks.pop_back();
+            }
+        }
     }
 }
 
-/*
-void DrawWorld() {
-    Rectangle area = game.map.GetArea(game.cam, tileWidth, tileHeight);
-    
-    for (int y = area.y; y < game.map.height; y++) {
-        for (const auto &[id, name] : game.layersIds) {
-            int yoffset = 0;
-            if (id > 1) {
-                yoffset = id - 1;
-                if (y - yoffset < 0) {
-                    continue;
+void Tilemap::StreamChunks(Camera2D camera) {
+    if (!stream) return;
+
+    std::vector<int> arrived;
+    stream->Update(GetArea(camera, tileWidth, tileHeight), arrived);
+
+    // Baked chunks under a chunk that just came in were baked without its tiles
+    for (int chunkIndex : arrived) {
+        int firstX = (chunkIndex % stream->ChunksX()) * streamChunkSize / chunkSize;
+        int firstY = (chunkIndex / stream->ChunksX()) * streamChunkSize / chunkSize;
+
+        for (auto &[name, layer] : layers) {
+            for (int y = firstY; y < firstY + streamChunkSize / chunkSize && y < layer.chunksY; y++) {
+                for (int x = firstX; x < firstX + streamChunkSize / chunkSize && x < layer.chunksX; x++) {
+                    layer.chunks[y * layer.chunksX + x].dirty = true;
                 }
             }
-            
-            if (y - yoffset >= area.height) continue;
-
-            game.map.DrawLayer(name, game.tilesets, game.cam, Rectangle {area.x, (float) y - yoffset, area.width, (float) (y - yoffset) + 1}, Vector2 {0, 0}, WHITE);
-        
-            if (id == 0) {
-                if (y * tileHeight <= player.rect.y + player.rect.height && player.rect.y + player.rect.height < (y + 1) * tileHeight) {
-                    player.Draw(game.tilesets, game.cam);
+        }
+    }
+}
+
+void Tilemap::UnloadChunks() {
+    for (auto &[name, layer] : layers) {
+        for (int chunkIndex : layer.residentChunks) {
+            UnloadChunk(layer, chunkIndex);
+        }
+        layer.residentChunks.clear();
+    }
+}
+
+void BakeChunk(Layer &layer, int chunkIndex, TilesetCollection &tilesets, Vector2 tileSize) {
+    TileChunk &chunk = layer.chunks[chunkIndex];
+    int startX = (chunkIndex % layer.chunksX) * chunkSize;
+    int startY = (chunkIndex / layer.chunksX) * chunkSize;
+    int endX = std::min(startX + chunkSize, layer.width);
+    int endY = std::min(startY + chunkSize, layer.height);
+
+    chunk.animatedTiles.clear();
+    BeginTextureMode(chunk.texture);
+        ClearBackground(BLANK);
+
+        for (int y = startY; y < endY; y++) {
+            for (int x = startX; x < endX; x++) {
+                Tile *tile = layer.Getat(Vector2 {(float) x, (float) y});
+                if (tile == nullptr || tile->Gid() == 0) continue;
+
+                TileInfo &info = tilesets.GetTile(tile->Gid());
+                if (info.tileset < 0) continue;
+
+                if (info.clip >= 0) {
+                    chunk.animatedTiles.push_back(y * layer.width + x);
+                    continue;
                 }
+
+                Rectangle dest = {(x - startX) * tileSize.x, (y - startY) * tileSize.y, tileSize.x, tileSize.y};
+                DrawFlippedTile(info.image, info.source, dest, *tile, WHITE);
             }
         }
+    EndTextureMode();
+
+    chunk.dirty = false;
+}
+
+void UnloadChunk(Layer &layer, int chunkIndex) {
+    TileChunk &chunk = layer.chunks[chunkIndex];
+    UnloadRenderTexture(chunk.texture);
+    chunk.texture = {};
+    chunk.resident = false;
+    chunk.dirty = true;
+    chunk.animatedTiles.clear();
+}
+
+ChunkStream::~ChunkStream() {
+    Close();
+}
+
+bool ChunkStream::Open(const std::string &_folder, int _layerCount, int width, int height) {
+    Close();
+    folder = _folder;
+    layerCount = _layerCount;
+    chunksX = (width + streamChunkSize - 1) / streamChunkSize;
+    chunksY = (height + streamChunkSize - 1) / streamChunkSize;
+    chunks.resize(chunksX * chunksY);
+    requested.assign(chunksX * chunksY, false);
+    stopping = false;
+
+#if !defined(PLATFORM_WEB)
+    worker = std::thread(&ChunkStream::WorkerLoop, this);
+#endif
+    return layerCount > 0;
+}
+
+void ChunkStream::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        requests.clear();
+    }
+    requestsChanged.notify_all();
+    if (worker.joinable()) worker.join();
+
+    finished.clear();
+    chunks.clear();
+    resident.clear();
+    requested.clear();
+    paged.clear();
+}
+
+Tile *ChunkStream::Edit(int layer, int x, int y) {
+    int chunkIndex = (y / streamChunkSize) * chunksX + x / streamChunkSize;
+    if (!chunks[chunkIndex]) {
+        // A worker may be reading the same file, Update drops its copy since this one is already in
+        chunks[chunkIndex] = ReadChunk(chunkIndex);
+        chunks[chunkIndex]->lastUsed = frame;
+        resident.push_back(chunkIndex);
+        paged.push_back(chunkIndex);
+    }
+    chunks[chunkIndex]->edited = true;
+    return Get(layer, x, y);
+}
+
+void ChunkStream::Update(Rectangle area, std::vector<int> &arrived) {
+    frame++;
+
+    // One chunk of margin so chunks come in before they scroll into view
+    int firstX = std::max((int) area.x / streamChunkSize - 1, 0);
+    int firstY = std::max((int) area.y / streamChunkSize - 1, 0);
+    int lastX = std::min(((int) area.width - 1) / streamChunkSize + 1, chunksX - 1);
+    int lastY = std::min(((int) area.height - 1) / streamChunkSize + 1, chunksY - 1);
+
+    std::vector<int> wanted;
+    for (int chunkY = firstY; chunkY <= lastY; chunkY++) {
+        for (int chunkX = firstX; chunkX <= lastX; chunkX++) {
+            int chunkIndex = chunkY * chunksX + chunkX;
+            if (chunks[chunkIndex])
+                chunks[chunkIndex]->lastUsed = frame;
+            else
+                wanted.push_back(chunkIndex);
+        }
+    }
+
+    {
+        // Requests that went out of range before a worker got to them are dropped
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int chunkIndex : requests) {
+            requested[chunkIndex] = false;
+        }
+        requests.clear();
+
+        for (int chunkIndex : wanted) {
+            if (requested[chunkIndex]) continue;
+            requested[chunkIndex] = true;
+            requests.push_back(chunkIndex);
+        }
+    }
+    requestsChanged.notify_one();
+
+#if defined(PLATFORM_WEB)
+    // No threads on the web, the files are read right here
+    for (int chunkIndex : requests) {
+        finished.push_back({chunkIndex, ReadChunk(chunkIndex)});
+    }
+    requests.clear();
+#endif
+
+    std::vector<std::pair<int, std::unique_ptr<StreamedChunk>>> taken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        taken.swap(finished);
+    }
+    for (auto &[chunkIndex, chunk] : taken) {
+        requested[chunkIndex] = false;
+        if (chunks[chunkIndex]) continue;
+
+        chunk->lastUsed = frame;
+        chunks[chunkIndex] = std::move(chunk);
+        resident.push_back(chunkIndex);
+        arrived.push_back(chunkIndex);
+    }
+    arrived.insert(arrived.end(), paged.begin(), paged.end());
+    paged.clear();
+
+    // Drop the chunks that went unseen the longest, edited ones are kept
+    size_t chunkBytes = (size_t) layerCount * streamChunkSize * streamChunkSize * sizeof(Tile);
+    if (resident.size() * chunkBytes > streamBudget) {
+        std::sort(resident.begin(), resident.end(), [this](int a, int b) {
+            if (chunks[a]->edited != chunks[b]->edited) return chunks[a]->edited;
+            return chunks[a]->lastUsed > chunks[b]->lastUsed;
+        });
+        while (resident.size() * chunkBytes > streamBudget) {
+            StreamedChunk *oldest = chunks[resident.back()].get();
+            if (oldest->edited || oldest->lastUsed == frame) break;
+
+            chunks[resident.back()].reset();
+            resident.pop_back();
+        }
+    }
+}
+
+void ChunkStream::WorkerLoop() {
+    while (true) {
+        int chunkIndex;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            requestsChanged.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+
+            chunkIndex = requests.front();
+            requests.pop_front();
+        }
+
+        std::unique_ptr<StreamedChunk> chunk = ReadChunk(chunkIndex);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back({chunkIndex, std::move(chunk)});
+    }
+}
+
+// A missing or broken file reads as an empty chunk
+std::unique_ptr<ChunkStream::StreamedChunk> ChunkStream::ReadChunk(int chunkIndex) {
+    int chunkX = chunkIndex % chunksX;
+    int chunkY = chunkIndex / chunksX;
+    std::unique_ptr<StreamedChunk> chunk = std::make_unique<StreamedChunk>();
+    chunk->tiles.assign(layerCount * streamChunkSize * streamChunkSize, Tile {0});
+
+    FILE *file = fopen(ChunkFilePath(folder, chunkX, chunkY).c_str(), "rb");
+    if (file == nullptr) return chunk;
+
+    StreamChunkHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, streamChunkMagic, 4) == 0
+        && header.version == mapCacheVersion && header.chunkX == chunkX && header.chunkY == chunkY
+        && (int) header.layerCount == layerCount && header.chunkSize == streamChunkSize;
+    if (!valid || fread(chunk->tiles.data(), sizeof(Tile), chunk->tiles.size(), file) != chunk->tiles.size()) {
+        std::fill(chunk->tiles.begin(), chunk->tiles.end(), Tile {0});
+    }
+
+    fclose(file);
+    return chunk;
+}
+
+void DrawTile(unsigned int gid, Vector2 pos, TilesetCollection &tilesets, Camera2D cam, Color tint, bool flippedX, bool flippedY) {
+    Tile tile = {gid};
+    if (tile.Gid() == 0) return;
+
+    TileInfo &info = tilesets.GetTile(tile.Gid());
+    if (info.tileset >= 0) {
+        Rectangle dest = {
+            (pos.x - cam.offset.x) * cam.zoom, 
+            (pos.y - cam.offset.y) * cam.zoom, 
+            info.source.width * cam.zoom, 
+            info.source.height * cam.zoom
+        };
+        if (!CheckCollisionRecs(dest, Rectangle {0, 0, (float) GetScreenWidth(), (float) GetScreenHeight()})) return;
+
+        if (flippedX) tile.cell ^= flippedHorizontally;
+        if (flippedY) tile.cell ^= flippedVertically;
+        DrawFlippedTile(info.image, info.source, dest, tile, tint);
     }
 }
-*/
\ No newline at end of file
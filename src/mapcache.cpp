@@ -0,0 +1,477 @@
+#include "mapcache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include "mapped.h"
+
+// Size of one record of each table, in MapCacheTables order
+const size_t recordSizes[mapCacheTableCount] = {
+    1,
+    sizeof(CachedProperty),
+    sizeof(CachedLayer),
+    sizeof(uint32_t),
+    sizeof(CachedObjectLayer),
+    sizeof(CachedObject),
+    sizeof(CachedText),
+    sizeof(CachedTileset),
+    sizeof(CachedFrame),
+    sizeof(CachedHitbox)
+};
+
+// Collects the tables in memory and writes them out in one go
+class MapCacheWriter {
+public:
+    MapCacheWriter() {
+        Intern("");
+    }
+
+    uint32_t Intern(const std::string &text) {
+        auto found = interned.find(text);
+        if (found != interned.end()) return found->second;
+
+        uint32_t offset = (uint32_t) tables[StringsTable].size();
+        tables[StringsTable].insert(tables[StringsTable].end(), text.c_str(), text.c_str() + text.size() + 1);
+        interned[text] = offset;
+        return offset;
+    }
+
+    template<typename T>
+    void Add(int table, const T &record) {
+        const unsigned char *bytes = (const unsigned char *) &record;
+        tables[table].insert(tables[table].end(), bytes, bytes + sizeof(T));
+    }
+
+    uint64_t Count(int table) {
+        return tables[table].size() / recordSizes[table];
+    }
+
+    CachedProperties AddProperties(PropertyCollection &properties) {
+        CachedProperties range = {(uint32_t) Count(PropertiesTable), (uint32_t) properties.properties.size()};
+        for (Property &property : properties.properties) {
+            CachedProperty cached = {Intern(property.Name()), (uint32_t) property.type, 0, Intern(property.text)};
+            if (property.type == ColorProperty)
+                memcpy(&cached.value, &property.colorValue, sizeof(Color));
+            else
+                memcpy(&cached.value, &property.intValue, sizeof(uint32_t));
+            Add(PropertiesTable, cached);
+        }
+        return range;
+    }
+
+    bool Write(MapCacheHeader &header, const char *path) {
+        memcpy(header.magic, mapCacheMagic, 4);
+        header.version = mapCacheVersion;
+
+        uint64_t offset = sizeof(MapCacheHeader);
+        for (int table = 0; table < mapCacheTableCount; table++) {
+            offset = (offset + mapCacheAlignment - 1) / mapCacheAlignment * mapCacheAlignment;
+            header.tables[table] = MapCacheTable {offset, Count(table)};
+            offset += tables[table].size();
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out) return false;
+        out.write((const char *) &header, sizeof(header));
+
+        for (int table = 0; table < mapCacheTableCount; table++) {
+            while ((uint64_t) out.tellp() < header.tables[table].offset) out.put(0);
+            out.write((const char *) tables[table].data(), tables[table].size());
+        }
+        return (bool) out;
+    }
+
+private:
+    std::vector<unsigned char> tables[mapCacheTableCount];
+    std::unordered_map<std::string, uint32_t> interned;
+};
+
+// The mapped file plus checked access to its tables
+class MapCacheReader {
+public:
+    const MapCacheHeader *header = nullptr;
+
+    ~MapCacheReader() {
+        file.Close();
+    }
+
+    bool Open(const char *path) {
+        if (!file.Open(path) || file.Size() < sizeof(MapCacheHeader)) return false;
+
+        header = (const MapCacheHeader *) file.Data();
+        if (memcmp(header->magic, mapCacheMagic, 4) != 0 || header->version != mapCacheVersion) return false;
+
+        for (int table = 0; table < mapCacheTableCount; table++) {
+            const MapCacheTable &range = header->tables[table];
+            if (range.offset % mapCacheAlignment != 0 || range.offset > file.Size()
+                || range.count > (file.Size() - range.offset) / recordSizes[table]) return false;
+        }
+
+        // Every string has to end inside the table
+        const MapCacheTable &strings = header->tables[StringsTable];
+        return strings.count > 0 && file.Data()[strings.offset + strings.count - 1] == '\0';
+    }
+
+    template<typename T>
+    const T *Table(int table) {
+        return (const T *) (file.Data() + header->tables[table].offset);
+    }
+
+    bool InRange(int table, uint64_t first, uint64_t count) {
+        return first <= header->tables[table].count && count <= header->tables[table].count - first;
+    }
+
+    std::string String(uint32_t offset) {
+        if (offset >= header->tables[StringsTable].count) return std::string();
+        return std::string(Table<char>(StringsTable) + offset);
+    }
+
+    bool ReadProperties(CachedProperties range, PropertyCollection &properties) {
+        if (!InRange(PropertiesTable, range.first, range.count)) return false;
+
+        const CachedProperty *cached = Table<CachedProperty>(PropertiesTable) + range.first;
+        properties.properties.reserve(range.count);
+        for (uint32_t index = 0; index < range.count; index++) {
+            if (cached[index].type > ObjectProperty) return false;
+
+            // The same few names repeat on every object, so each is interned once per file
+            auto key = keys.find(cached[index].name);
+            if (key == keys.end()) key = keys.emplace(cached[index].name, InternProperty(String(cached[index].name))).first;
+
+            Property property;
+            property.key = key->second;
+            property.type = (PropertyType) cached[index].type;
+            if (property.type == ColorProperty)
+                memcpy(&property.colorValue, &cached[index].value, sizeof(Color));
+            else if (property.type == BoolProperty)
+                property.boolValue = cached[index].value & 1;
+            else
+                memcpy(&property.intValue, &cached[index].value, sizeof(uint32_t));
+            if (cached[index].text != 0) property.text = String(cached[index].text);
+            properties.Add(property);
+        }
+        return true;
+    }
+
+private:
+    MappedFile file;
+    std::unordered_map<uint32_t, int> keys;     // String offset to interned property key
+};
+
+std::string MapCachePath(const char *source) {
+    return std::string(source) + mapCacheExtension;
+}
+
+std::string ChunkFolderPath(const char *source) {
+    return std::string(source) + ".chunks";
+}
+
+std::string ChunkFilePath(const std::string &chunkFolder, int chunkX, int chunkY) {
+    return chunkFolder + "/" + std::to_string(chunkX) + "_" + std::to_string(chunkY) + streamChunkExtension;
+}
+
+bool IsMapCacheFresh(const char *source) {
+    // Compares the file system's own timestamps, finer than a second on most of them. Equal
+    // times count as stale, so a cache is never trusted over a map saved at the same moment.
+    // Nothing rebuilds a stale cache at load time: LoadMap and LoadSet parse the Tiled file on
+    // every launch until "make maps" runs again. Files that ship with identical times, as
+    // unpacked archives often do, never use their cache
+    std::error_code error;
+    auto cacheTime = std::filesystem::last_write_time(MapCachePath(source), error);
+    if (error) return false;
+    auto sourceTime = std::filesystem::last_write_time(source, error);
+    return !error && cacheTime > sourceTime;
+}
+
+// Streamed maps keep the layer records but leave their tiles to the chunk files
+bool SaveMap(Tilemap &map, const char *path, const char *chunkFolder) {
+    MapCacheWriter writer;
+    MapCacheHeader header = {};
+    header.kind = chunkFolder ? CachedStreamedMapFile : CachedMapFile;
+    header.chunkFolder = chunkFolder ? writer.Intern(chunkFolder) : 0;
+    header.width = map.width;
+    header.height = map.height;
+    header.tileWidth = map.tileWidth;
+    header.tileHeight = map.tileHeight;
+    header.orientation = map.orientation;
+    header.renderOrder = map.renderOrder;
+    header.properties = writer.AddProperties(map.properties);
+
+    uint64_t firstTile = 0;
+    for (std::string &name : map.layerNames) {
+        Layer &layer = map.layers[name];
+        CachedLayer cached = {};
+        cached.name = writer.Intern(layer.name);
+        cached.id = layer.id;
+        cached.width = layer.width;
+        cached.height = layer.height;
+        cached.opacity = layer.opacity;
+        cached.visible = layer.visible;
+        cached.firstTile = firstTile;
+        cached.properties = writer.AddProperties(layer.properties);
+        writer.Add(LayersTable, cached);
+        if (chunkFolder) continue;
+
+        for (Tile &tile : layer.tiles) {
+            writer.Add(TilesTable, (uint32_t) tile.cell);
+        }
+        firstTile += layer.tiles.size();
+    }
+
+    for (auto &[layerName, layer] : map.objectLayers) {
+        CachedObjectLayer cached = {};
+        cached.name = writer.Intern(layer.name);
+        cached.id = layer.id;
+        cached.firstObject = (uint32_t) writer.Count(ObjectsTable);
+        cached.properties = writer.AddProperties(layer.properties);
+
+        for (Object &object : layer.objects) {
+            CachedObject cachedObject = {};
+            cachedObject.name = writer.Intern(object.name);
+            cachedObject.id = object.id;
+            cachedObject.x = object.rect.x;
+            cachedObject.y = object.rect.y;
+            cachedObject.width = object.rect.width;
+            cachedObject.height = object.rect.height;
+            cachedObject.shape = (uint32_t) object.shape;
+            cachedObject.text = -1;
+            cachedObject.properties = writer.AddProperties(object.properties);
+
+            TextObject *text = layer.GetText(object);
+            if (text != nullptr) {
+                uint32_t flags = (text->wrap ? (uint32_t) TextWrap : 0u) | (text->bold ? (uint32_t) TextBold : 0u) | (text->italic ? (uint32_t) TextItalic : 0u)
+                    | (text->underline ? (uint32_t) TextUnderline : 0u) | (text->strikeout ? (uint32_t) TextStrikeout : 0u) | (text->kerning ? (uint32_t) TextKerning : 0u);
+                CachedText cachedText = {writer.Intern(text->text), writer.Intern(text->fontFamily), writer.Intern(text->horizontalAlignment),
+                                         writer.Intern(text->verticalAlignment), text->fontSize, flags,
+                                         {text->textColor.r, text->textColor.g, text->textColor.b, text->textColor.a}};
+                cachedObject.text = (int32_t) writer.Count(TextsTable);
+                writer.Add(TextsTable, cachedText);
+            }
+
+            writer.Add(ObjectsTable, cachedObject);
+            cached.objectCount++;
+        }
+        writer.Add(ObjectLayersTable, cached);
+    }
+
+    return writer.Write(header, path);
+}
+
+bool SaveMapCache(Tilemap &map, const char *path) {
+    return SaveMap(map, path, nullptr);
+}
+
+bool SaveStreamedMapCache(Tilemap &map, const char *path, const char *chunkFolder) {
+    std::error_code error;
+    std::filesystem::remove_all(chunkFolder, error);
+    if (!std::filesystem::create_directories(chunkFolder, error)) return false;
+
+    int layerCount = (int) map.layerNames.size();
+    int chunksX = (map.width + streamChunkSize - 1) / streamChunkSize;
+    int chunksY = (map.height + streamChunkSize - 1) / streamChunkSize;
+    std::vector<uint32_t> cells(layerCount * streamChunkSize * streamChunkSize);
+
+    for (int chunkY = 0; chunkY < chunksY; chunkY++) {
+        for (int chunkX = 0; chunkX < chunksX; chunkX++) {
+            std::fill(cells.begin(), cells.end(), 0);
+            bool empty = true;
+
+            for (int layerIndex = 0; layerIndex < layerCount; layerIndex++) {
+                Layer &layer = map.layers[map.layerNames[layerIndex]];
+                for (int y = 0; y < streamChunkSize; y++) {
+                    for (int x = 0; x < streamChunkSize; x++) {
+                        Tile *tile = layer.Getat(Vector2 {(float) (chunkX * streamChunkSize + x), (float) (chunkY * streamChunkSize + y)});
+                        if (tile == nullptr || tile->cell == 0) continue;
+
+                        cells[(layerIndex * streamChunkSize + y) * streamChunkSize + x] = tile->cell;
+                        empty = false;
+                    }
+                }
+            }
+            if (empty) continue;
+
+            StreamChunkHeader header = {};
+            memcpy(header.magic, streamChunkMagic, 4);
+            header.version = mapCacheVersion;
+            header.chunkX = chunkX;
+            header.chunkY = chunkY;
+            header.layerCount = layerCount;
+            header.chunkSize = streamChunkSize;
+
+            std::ofstream out(ChunkFilePath(chunkFolder, chunkX, chunkY), std::ios::binary);
+            out.write((const char *) &header, sizeof(header));
+            out.write((const char *) cells.data(), cells.size() * sizeof(uint32_t));
+            if (!out) return false;
+        }
+    }
+
+    return SaveMap(map, path, chunkFolder);
+}
+
+bool SaveTilesetCache(Tileset &tileset, const char *path) {
+    MapCacheWriter writer;
+    MapCacheHeader header = {};
+    header.kind = CachedTilesetFile;
+    header.width = tileset.width;
+    header.height = tileset.height;
+    header.tileWidth = tileset.tileWidth;
+    header.tileHeight = tileset.tileHeight;
+    header.properties = writer.AddProperties(tileset.properties);
+
+    writer.Add(TilesetTable, CachedTileset {
+        writer.Intern(tileset.name), writer.Intern(tileset.path), tileset.width, tileset.height,
+        tileset.tileWidth, tileset.tileHeight, tileset.tileCount, tileset.startingGid
+    });
+
+    for (auto &[tile, frames] : tileset.animations) {
+        for (Frame &frame : frames) {
+            writer.Add(FramesTable, CachedFrame {tile, frame.gid, frame.duration});
+        }
+    }
+
+    for (auto &[tile, rects] : tileset.hitboxes) {
+        // A tile with an empty object group still has its entry
+        if (rects.empty()) writer.Add(HitboxesTable, CachedHitbox {tile, 0, 0, -1, -1});
+        for (Rectangle &rect : rects) {
+            writer.Add(HitboxesTable, CachedHitbox {tile, rect.x, rect.y, rect.width, rect.height});
+        }
+    }
+
+    return writer.Write(header, path);
+}
+
+bool LoadMapCache(const char *path, Tilemap &map) {
+    MapCacheReader reader;
+    if (!reader.Open(path) || (reader.header->kind != CachedMapFile && reader.header->kind != CachedStreamedMapFile)) return false;
+
+    const MapCacheHeader &header = *reader.header;
+    map.width = header.width;
+    map.height = header.height;
+    map.tileWidth = header.tileWidth;
+    map.tileHeight = header.tileHeight;
+    map.orientation = (Orientation) header.orientation;
+    map.renderOrder = (RenderOrder) header.renderOrder;
+    map.rect = Rectangle {0, 0, (float) map.width * map.tileWidth, (float) map.height * map.tileHeight};
+    if (!reader.ReadProperties(header.properties, map.properties)) return false;
+
+    bool streamed = header.kind == CachedStreamedMapFile;
+    if (streamed) {
+        map.stream = std::make_shared<ChunkStream>();
+        if (!map.stream->Open(reader.String(header.chunkFolder), (int) header.tables[LayersTable].count, map.width, map.height)) return false;
+    }
+
+    const CachedLayer *layers = reader.Table<CachedLayer>(LayersTable);
+    const uint32_t *cells = reader.Table<uint32_t>(TilesTable);
+    for (uint64_t index = 0; index < header.tables[LayersTable].count; index++) {
+        const CachedLayer &cached = layers[index];
+        uint64_t tileCount = streamed ? 0 : (uint64_t) std::max(cached.width, 0) * std::max(cached.height, 0);
+        if (!reader.InRange(TilesTable, cached.firstTile, tileCount)) return false;
+
+        std::string name = reader.String(cached.name);
+        Layer &layer = map.layers[name];
+        layer.name = name;
+        layer.id = cached.id;
+        layer.width = cached.width;
+        layer.height = cached.height;
+        layer.opacity = cached.opacity;
+        layer.visible = cached.visible != 0;
+        if (!reader.ReadProperties(cached.properties, layer.properties)) return false;
+
+        // Tile is a single cell, so the cells copy over as they are
+        static_assert(sizeof(Tile) == sizeof(uint32_t), "Tile has to match the cached cell layout");
+        // Streamed layers have none here, their tiles stay in the chunk files
+        if (tileCount > 0) {
+            layer.tiles.resize(tileCount);
+            memcpy(layer.tiles.data(), cells + cached.firstTile, tileCount * sizeof(uint32_t));
+        }
+        layer.InitChunks();
+
+        // Streamed layers must span the whole map since they share its chunk grid
+        if (streamed) {
+            if (layer.width != map.width || layer.height != map.height) return false;
+            layer.stream = map.stream.get();
+            layer.streamLayer = (int) index;
+        }
+
+        map.layerNames.push_back(name);
+    }
+
+    const CachedObjectLayer *objectLayers = reader.Table<CachedObjectLayer>(ObjectLayersTable);
+    const CachedObject *objects = reader.Table<CachedObject>(ObjectsTable);
+    const CachedText *texts = reader.Table<CachedText>(TextsTable);
+    for (uint64_t index = 0; index < header.tables[ObjectLayersTable].count; index++) {
+        const CachedObjectLayer &cached = objectLayers[index];
+        if (!reader.InRange(ObjectsTable, cached.firstObject, cached.objectCount)) return false;
+
+        std::string name = reader.String(cached.name);
+        ObjectLayer &layer = map.objectLayers[name];
+        layer.name = name;
+        layer.id = cached.id;
+        if (!reader.ReadProperties(cached.properties, layer.properties)) return false;
+
+        for (uint32_t objectIndex = cached.firstObject; objectIndex < cached.firstObject + cached.objectCount; objectIndex++) {
+            const CachedObject &cachedObject = objects[objectIndex];
+            Object object;
+            object.id = cachedObject.id;
+            object.name = reader.String(cachedObject.name);
+            object.rect = Rectangle {cachedObject.x, cachedObject.y, cachedObject.width, cachedObject.height};
+            if (cachedObject.shape > TextShape) return false;
+            object.shape = (ObjectShape) cachedObject.shape;
+            if (!reader.ReadProperties(cachedObject.properties, object.properties)) return false;
+
+            if (cachedObject.text >= 0) {
+                if (!reader.InRange(TextsTable, cachedObject.text, 1)) return false;
+                const CachedText &cachedText = texts[cachedObject.text];
+                TextObject text;
+                text.text = reader.String(cachedText.text);
+                text.fontFamily = reader.String(cachedText.fontFamily);
+                text.horizontalAlignment = reader.String(cachedText.horizontalAlignment);
+                text.verticalAlignment = reader.String(cachedText.verticalAlignment);
+                text.fontSize = cachedText.fontSize;
+                text.wrap = cachedText.flags & TextWrap;
+                text.bold = cachedText.flags & TextBold;
+                text.italic = cachedText.flags & TextItalic;
+                text.underline = cachedText.flags & TextUnderline;
+                text.strikeout = cachedText.flags & TextStrikeout;
+                text.kerning = cachedText.flags & TextKerning;
+                text.textColor = Color {cachedText.color[0], cachedText.color[1], cachedText.color[2], cachedText.color[3]};
+
+                object.text = (int) layer.texts.size();
+                layer.texts.push_back(text);
+            }
+            layer.Add(object);
+        }
+    }
+
+    return true;
+}
+
+bool LoadTilesetCache(const char *path, Tileset &tileset) {
+    MapCacheReader reader;
+    if (!reader.Open(path) || reader.header->kind != CachedTilesetFile || reader.header->tables[TilesetTable].count != 1) return false;
+
+    const CachedTileset &cached = *reader.Table<CachedTileset>(TilesetTable);
+    tileset.name = reader.String(cached.name);
+    tileset.path = reader.String(cached.path);
+    tileset.width = cached.width;
+    tileset.height = cached.height;
+    tileset.tileWidth = cached.tileWidth;
+    tileset.tileHeight = cached.tileHeight;
+    tileset.tileCount = cached.tileCount;
+    tileset.startingGid = cached.startingGid;
+    if (!reader.ReadProperties(reader.header->properties, tileset.properties)) return false;
+
+    const CachedFrame *frames = reader.Table<CachedFrame>(FramesTable);
+    for (uint64_t index = 0; index < reader.header->tables[FramesTable].count; index++) {
+        tileset.animations[frames[index].tile].push_back(Frame {frames[index].gid, frames[index].duration});
+    }
+
+    const CachedHitbox *hitboxes = reader.Table<CachedHitbox>(HitboxesTable);
+    for (uint64_t index = 0; index < reader.header->tables[HitboxesTable].count; index++) {
+        const CachedHitbox &hitbox = hitboxes[index];
+        std::vector<Rectangle> &rects = tileset.hitboxes[hitbox.tile];
+        if (hitbox.width >= 0) rects.push_back(Rectangle {hitbox.x, hitbox.y, hitbox.width, hitbox.height});
+    }
+
+    return true;
+}
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <cstdlib>
+#include "mapped.h"
+
+// raylib.h clashes with windows.h, so this file only deals in bytes
+#if defined(PLATFORM_WEB)
+#elif defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool MappedFile::Open(const char *path) {
+    Close();
+
+#if defined(PLATFORM_WEB)
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+
+    fseek(file, 0, SEEK_END);
+    size_t fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *buffer = (unsigned char *) malloc(fileSize);
+    if (fread(buffer, 1, fileSize, file) != fileSize) {
+        free(buffer);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    data = buffer;
+    size = fileSize;
+#elif defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+
+    HANDLE fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!fileMapping) return false;
+
+    data = (const unsigned char *) MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(fileMapping);
+        return false;
+    }
+    size = (size_t) fileSize.QuadPart;
+    mapping = fileMapping;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat info;
+    fstat(file, &info);
+    if (info.st_size == 0) {
+        close(file);
+        return false;
+    }
+
+    void *view = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (view == MAP_FAILED) return false;
+    data = (const unsigned char *) view;
+    size = (size_t) info.st_size;
+#endif
+
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!data) return;
+
+#if defined(PLATFORM_WEB)
+    free((void *) data);
+#elif defined(_WIN32)
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE) mapping);
+#else
+    munmap((void *) data, size);
+#endif
+
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+}
@@ -0,0 +1,339 @@
+#include "post.h"
+
+struct EffectStage {
+    Shaders effect;
+    const char *name;
+    const char *code;
+};
+
+// Move where the frame is read from. FETCH is the stage inside this one, or the frame itself.
+// Innermost first, so fisheye bends the pixelated, stitched and edge detected image
+const EffectStage fetchStages[] = {
+    {FX_DREAM_VISION, "DreamVision", R"(
+vec4 DreamVision(vec2 uv)
+{
+    vec4 color = FETCH(uv);
+    for (int i = 0; i < 6; i++)
+    {
+        float offset = 0.001 + 0.002*float(i);
+        color += FETCH(uv + offset);
+        color += FETCH(uv - offset);
+    }
+
+    color.rgb = vec3((color.r + color.g + color.b)/3.0);
+    return color/9.5;
+}
+)"},
+    {FX_SOBEL, "Sobel", R"(
+vec4 Sobel(vec2 uv)
+{
+    vec2 texel = 1.0/size;
+    vec4 topLeft = FETCH(uv + vec2(-texel.x, -texel.y));
+    vec4 top = FETCH(uv + vec2(0.0, -texel.y));
+    vec4 topRight = FETCH(uv + vec2(texel.x, -texel.y));
+    vec4 left = FETCH(uv + vec2(-texel.x, 0.0));
+    vec4 right = FETCH(uv + vec2(texel.x, 0.0));
+    vec4 bottomLeft = FETCH(uv + vec2(-texel.x, texel.y));
+    vec4 bottom = FETCH(uv + vec2(0.0, texel.y));
+    vec4 bottomRight = FETCH(uv + vec2(texel.x, texel.y));
+
+    vec4 horizEdge = topRight + 2.0*right + bottomRight - topLeft - 2.0*left - bottomLeft;
+    vec4 vertEdge = bottomLeft + 2.0*bottom + bottomRight - topLeft - 2.0*top - topRight;
+    vec3 edge = sqrt(horizEdge.rgb*horizEdge.rgb + vertEdge.rgb*vertEdge.rgb);
+    return vec4(edge, FETCH(uv).a);
+}
+)"},
+    {FX_CROSS_STITCHING, "CrossStitching", R"(
+vec4 CrossStitching(vec2 uv)
+{
+    float stitchingSize = 6.0;
+    vec2 cPos = uv*size;
+    vec2 tlPos = floor(cPos/stitchingSize)*stitchingSize;
+
+    int remX = int(mod(cPos.x, stitchingSize));
+    int remY = int(mod(cPos.y, stitchingSize));
+    if (remX == 0 && remY == 0) tlPos = cPos;
+
+    vec2 blPos = vec2(tlPos.x, tlPos.y + stitchingSize - 1.0);
+    if (remX == remY || int(cPos.x) - int(blPos.x) == int(blPos.y) - int(cPos.y)) return FETCH(tlPos/size)*1.4;
+    return vec4(0.0, 0.0, 0.0, 1.0);
+}
+)"},
+    {FX_PIXELIZER, "Pixelizer", R"(
+vec4 Pixelizer(vec2 uv)
+{
+    vec2 pixel = 5.0/size;
+    return vec4(FETCH(pixel*floor(uv/pixel)).rgb, 1.0);
+}
+)"},
+    {FX_FISHEYE, "Fisheye", R"(
+vec4 Fisheye(vec2 uv)
+{
+    const float PI = 3.1415926535;
+    float maxFactor = sin(0.5*178.0*(PI/180.0));
+    vec2 xy = 2.0*uv - 1.0;
+    float d = length(xy);
+
+    if (d < (2.0 - maxFactor))
+    {
+        d = length(xy*maxFactor);
+        float z = sqrt(1.0 - d*d);
+        float r = atan(d, z)/PI;
+        float phi = atan(xy.y, xy.x);
+        uv = vec2(r*cos(phi) + 0.5, r*sin(phi) + 0.5);
+    }
+
+    return FETCH(uv);
+}
+)"},
+};
+
+// Recolor what the fetches return, in this order
+const EffectStage colorStages[] = {
+    {FX_PREDATOR_VIEW, "PredatorView", R"(
+vec4 PredatorView(vec4 color)
+{
+    float lum = (color.r + color.g + color.b)/3.0;
+    vec3 tc;
+    if (lum < 0.5) tc = mix(vec3(0.0, 0.0, 1.0), vec3(1.0, 1.0, 0.0), lum/0.5);
+    else tc = mix(vec3(1.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), (lum - 0.5)/0.5);
+    return vec4(tc, 1.0);
+}
+)"},
+    {FX_GRAYSCALE, "Grayscale", R"(
+vec4 Grayscale(vec4 color)
+{
+    float gray = dot(color.rgb, vec3(0.299, 0.587, 0.114));
+    return vec4(gray, gray, gray, color.a);
+}
+)"},
+    {FX_POSTERIZATION, "Posterization", R"(
+vec4 Posterization(vec4 color)
+{
+    float gamma = 0.6;
+    float numColors = 8.0;
+    vec3 tc = pow(color.rgb, vec3(gamma));
+    tc = floor(tc*numColors)/numColors;
+    return vec4(pow(tc, vec3(1.0/gamma)), 1.0);
+}
+)"},
+    {FX_CROSS_HATCHING, "CrossHatching", R"(
+vec4 CrossHatching(vec4 color)
+{
+    float hatchOffsetY = 5.0;
+    float lum = length(color.rgb);
+    vec2 pos = gl_FragCoord.xy;
+    vec3 tc = vec3(1.0, 1.0, 1.0);
+
+    if (lum < 0.9 && mod(pos.x + pos.y, 10.0) == 0.0) tc = vec3(0.0, 0.0, 0.0);
+    if (lum < 0.7 && mod(pos.x - pos.y, 10.0) == 0.0) tc = vec3(0.0, 0.0, 0.0);
+    if (lum < 0.5 && mod(pos.x + pos.y - hatchOffsetY, 10.0) == 0.0) tc = vec3(0.0, 0.0, 0.0);
+    if (lum < 0.3 && mod(pos.x - pos.y - hatchOffsetY, 10.0) == 0.0) tc = vec3(0.0, 0.0, 0.0);
+    return vec4(tc, 1.0);
+}
+)"},
+    {FX_SCANLINES, "Scanlines", R"(
+vec4 Scanlines(vec4 color)
+{
+    float frequency = size.y/3.0;
+    float wavePos = cos((fract(fragTexCoord.y*frequency) - 0.5)*3.14);
+    return mix(vec4(0.0, 0.3, 0.0, 0.0), color, wavePos);
+}
+)"},
+};
+
+std::string GenerateEffectShader(EffectSet effects, int glslVersion) {
+    bool bloom = HasEffect(effects, FX_BLOOM);
+    bool blur = HasEffect(effects, FX_BLUR);
+    const char *sample = glslVersion == 100 ? "texture2D" : "texture";
+
+    std::string code;
+    if (glslVersion == 100) {
+        code += "#version 100\n\nprecision mediump float;\n\n";
+        code += "varying vec2 fragTexCoord;\nvarying vec4 fragColor;\n";
+    } else {
+        code += "#version 330\n\n";
+        code += "in vec2 fragTexCoord;\nin vec4 fragColor;\nout vec4 finalColor;\n";
+    }
+    code += "\nuniform sampler2D texture0;\nuniform vec4 colDiffuse;\nuniform vec2 size;\n";
+    if (bloom || blur) code += "uniform sampler2D texture1;\n";
+    if (bloom) code += TextFormat("const float bloomStrength = %.3f;\n", bloomStrength);
+
+    // The frame itself, with the glow added or swapped for its blurred copy. With both the
+    // glow is the bright part of the blurred copy, since there's only one offscreen result
+    code += "\nvec4 Fetch0(vec2 uv)\n{\n";
+    if (blur) {
+        code += TextFormat("    vec4 color = %s(texture1, uv);\n", sample);
+    } else {
+        code += TextFormat("    vec4 color = %s(texture0, uv);\n", sample);
+    }
+    if (bloom && blur) {
+        code += "    float brightness = max(color.r, max(color.g, color.b));\n";
+        code += "    color.rgb += color.rgb*max(brightness - 0.6, 0.0)/max(brightness, 0.0001)*bloomStrength;\n";
+    } else if (bloom) {
+        code += TextFormat("    color.rgb += %s(texture1, uv).rgb*bloomStrength;\n", sample);
+    }
+    code += "    return color;\n}\n";
+
+    std::string fetch = "Fetch0";
+    for (const EffectStage &stage : fetchStages) {
+        if (!HasEffect(effects, stage.effect)) continue;
+
+        std::string stageCode = stage.code;
+        for (size_t at = stageCode.find("FETCH("); at != std::string::npos; at = stageCode.find("FETCH(", at)) {
+            stageCode.replace(at, 5, fetch);
+        }
+        code += stageCode;
+        fetch = stage.name;
+    }
+    for (const EffectStage &stage : colorStages) {
+        if (HasEffect(effects, stage.effect)) code += stage.code;
+    }
+
+    code += "\nvoid main()\n{\n    vec4 color = " + fetch + "(fragTexCoord);\n";
+    for (const EffectStage &stage : colorStages) {
+        if (HasEffect(effects, stage.effect)) code += std::string("    color = ") + stage.name + "(color);\n";
+    }
+    code += glslVersion == 100 ? "    gl_FragColor = color*colDiffuse*fragColor;\n}\n" : "    finalColor = color*colDiffuse*fragColor;\n}\n";
+    return code;
+}
+
+void PostChain::Init(std::function<std::string(const char *fileName)> _loadSource) {
+    loadSource = _loadSource;
+    cache.Init();
+}
+
+void PostChain::Unload() {
+    UnloadTargets();
+    for (auto &[set, loaded] : programs) {
+        UnloadShader(loaded.shader);
+    }
+    for (Shader *pass : {&brightPass, &blur}) {
+        if (pass->id != 0) UnloadShader(*pass);
+        *pass = Shader {};
+    }
+    programs.clear();
+    pending.clear();
+    program = nullptr;
+    scene = nullptr;
+}
+
+void PostChain::Prepare(EffectSet _effects, RenderTexture2D &_scene) {
+    effects = _effects;
+    scene = &_scene;
+    program = &GetProgram(effects);
+
+    bool bloom = HasEffect(effects, FX_BLOOM);
+    if (!bloom && !HasEffect(effects, FX_BLUR)) return;
+
+    Texture2D &source = scene->texture;
+    Resize(source.width / postDownscale, source.height / postDownscale);
+
+    // Bloom alone keeps only what's bright, blur takes everything down with plain filtering
+    if (bloom && !HasEffect(effects, FX_BLUR)) {
+        SetSize(brightPass, Vector2 {(float) source.width, (float) source.height});
+        Pass(brightPass, source, targets[0], Vector2 {0, 0});
+    } else {
+        Pass(Shader {}, source, targets[0], Vector2 {0, 0});
+    }
+
+    int iterations = bloom ? bloomBlurIterations : 1;
+    Vector2 texel = {1.0f / targets[0].texture.width, 1.0f / targets[0].texture.height};
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        Pass(blur, targets[0].texture, targets[1], Vector2 {texel.x, 0});
+        Pass(blur, targets[1].texture, targets[0], Vector2 {0, texel.y});
+    }
+}
+
+void PostChain::Draw(Rectangle dest) {
+    if (scene == nullptr || program == nullptr) return;
+
+    // Render textures are stored upside down. The offscreen result is too, so both are
+    // read at the same coordinates
+    Texture2D &texture = scene->texture;
+    Rectangle source = {0, 0, (float) texture.width, (float) -texture.height};
+    Vector2 size = {dest.width, dest.height};
+
+    BeginShaderMode(program->shader);
+        if (program->sizeLocation >= 0) SetShaderValue(program->shader, program->sizeLocation, &size, SHADER_UNIFORM_VEC2);
+        if (program->resultLocation >= 0) SetShaderValueTexture(program->shader, program->resultLocation, targets[0].texture);
+        DrawTexturePro(texture, source, dest, Vector2 {0, 0}, 0, WHITE);
+    EndShaderMode();
+}
+
+void PostChain::Warm(EffectSet set) {
+    if (set == 0 || programs.count(set) != 0) return;
+    for (EffectSet queued : pending) {
+        if (queued == set) return;
+    }
+    pending.push_back(set);
+}
+
+void PostChain::CompilePending() {
+    if (pending.empty()) return;
+
+    EffectSet set = pending.back();
+    pending.pop_back();
+    GetProgram(set);
+}
+
+PostChain::Program &PostChain::GetProgram(EffectSet set) {
+    auto found = programs.find(set);
+    if (found != programs.end()) return found->second;
+
+    if (HasEffect(set, FX_BLOOM)) LoadPass(brightPass, "bloom.fs");
+    if (HasEffect(set, FX_BLOOM) || HasEffect(set, FX_BLUR)) LoadPass(blur, "blur.fs");
+
+    Program loaded;
+    loaded.shader = cache.Load(GenerateEffectShader(set, GLSL_VERSION));
+    loaded.sizeLocation = GetShaderLocation(loaded.shader, "size");
+    loaded.resultLocation = GetShaderLocation(loaded.shader, "texture1");
+    return programs[set] = loaded;
+}
+
+void PostChain::LoadPass(Shader &pass, const char *fileName) {
+    if (pass.id == 0) pass = cache.Load(loadSource(fileName));
+}
+
+void PostChain::Resize(int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (targets[0].texture.width == width && targets[0].texture.height == height) return;
+
+    // Bilinear so the blur's in-between taps and the final upscale are smooth
+    UnloadTargets();
+    for (RenderTexture2D &target : targets) {
+        target = LoadRenderTexture(width, height);
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+        SetTextureWrap(target.texture, TEXTURE_WRAP_CLAMP);
+    }
+}
+
+void PostChain::UnloadTargets() {
+    for (RenderTexture2D &target : targets) {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = RenderTexture2D {};
+    }
+}
+
+// Draws source over the whole of into, an empty shader draws it with raylib's default one
+void PostChain::Pass(Shader pass, Texture2D source, RenderTexture2D &into, Vector2 direction) {
+    if (pass.id != 0 && direction.x + direction.y != 0) {
+        int location = GetShaderLocation(pass, "direction");
+        SetShaderValue(pass, location, &direction, SHADER_UNIFORM_VEC2);
+    }
+
+    Rectangle sourceRect = {0, 0, (float) source.width, (float) -source.height};
+    Rectangle dest = {0, 0, (float) into.texture.width, (float) into.texture.height};
+    BeginTextureMode(into);
+        ClearBackground(BLACK);
+        if (pass.id != 0) BeginShaderMode(pass);
+        DrawTexturePro(source, sourceRect, dest, Vector2 {0, 0}, 0, WHITE);
+        if (pass.id != 0) EndShaderMode();
+    EndTextureMode();
+}
+
+void PostChain::SetSize(Shader pass, Vector2 size) {
+    int location = GetShaderLocation(pass, "size");
+    if (location >= 0) SetShaderValue(pass, location, &size, SHADER_UNIFORM_VEC2);
+}
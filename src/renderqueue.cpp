@@ -0,0 +1,129 @@
+#include "renderqueue.h"
+#include <cmath>
+
+const float depthSteps = 16;    // Key resolution per pixel, a screen's worth of depth then fits in the low two bytes
+
+// Fixed point with the sign bit flipped so negative depths sort first as plain integers
+uint32_t DepthKey(float depth) {
+    float steps = std::clamp(floorf(depth * depthSteps), -2147483520.0f, 2147483520.0f);
+    return (uint32_t) (int32_t) steps ^ 0x80000000;
+}
+
+// Least significant byte first, each pass is a stable counting sort. All four histograms come
+// from one walk over the keys. Most frames only span a few screens of depth, so the top bytes
+// are usually the same everywhere and those passes are skipped
+void RadixSort(const std::vector<uint32_t> &keys, std::vector<int> &order, std::vector<int> &scratch) {
+    int count = (int) keys.size();
+    order.resize(count);
+    scratch.resize(count);
+    for (int index = 0; index < count; index++) order[index] = index;
+    if (count < 2) return;
+
+    int buckets[4][256] = {};
+    for (uint32_t key : keys) {
+        buckets[0][key & 0xff]++;
+        buckets[1][(key >> 8) & 0xff]++;
+        buckets[2][(key >> 16) & 0xff]++;
+        buckets[3][key >> 24]++;
+    }
+
+    for (int pass = 0; pass < 4; pass++) {
+        int shift = pass * 8;
+        int *counts = buckets[pass];
+        if (counts[(keys[0] >> shift) & 0xff] == count) continue;
+
+        int start = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            int size = counts[bucket];
+            counts[bucket] = start;
+            start += size;
+        }
+        for (int index : order) {
+            scratch[counts[(keys[index] >> shift) & 0xff]++] = index;
+        }
+        order.swap(scratch);
+    }
+}
+
+void RenderQueue::AddLayer(Tilemap &map, Layer &layer, Rectangle area, int depthOffset, Vector2 offset, Color tint) {
+    if (!layer.visible) return;
+
+    for (int y = (int) area.y; y < (int) area.height && y < layer.height; y++) {
+        Command command = {};
+        command.kind = TileRowCommand;
+        command.map = &map;
+        command.layer = &layer;
+        command.area = Rectangle {area.x, (float) y, area.width, (float) y + 1};
+        command.offset = offset;
+        command.tint = tint;
+        Add(command, (float) (y + depthOffset) * map.tileHeight);
+    }
+}
+
+void RenderQueue::AddSprite(Texture2D texture, Rectangle source, Rectangle dest, float depth, Color tint) {
+    Command command = {};
+    command.kind = SpriteCommand;
+    command.texture = texture;
+    command.source = source;
+    command.dest = dest;
+    command.tint = tint;
+    Add(command, depth);
+}
+
+void RenderQueue::AddTile(unsigned int gid, Vector2 pos, float depth, Color tint) {
+    Command command = {};
+    command.kind = TileCommand;
+    command.gid = gid;
+    command.dest = Rectangle {pos.x, pos.y, 0, 0};
+    command.tint = tint;
+    Add(command, depth);
+}
+
+void RenderQueue::AddCustom(float depth, std::function<void()> draw) {
+    Command command = {};
+    command.kind = CustomCommand;
+    command.custom = (int) customs.size();
+    customs.push_back(draw);
+    Add(command, depth);
+}
+
+void RenderQueue::Add(const Command &command, float depth) {
+    commands.push_back(command);
+    keys.push_back(DepthKey(depth));
+}
+
+void RenderQueue::Flush(TilesetCollection &tilesets, Camera2D camera) {
+    RadixSort(keys, order, scratch);
+
+    for (int index : order) {
+        Command &command = commands[index];
+        switch (command.kind) {
+            case TileRowCommand:
+                command.map->DrawLayer(*command.layer, tilesets, camera, command.area, command.offset, command.tint);
+                break;
+            case SpriteCommand: {
+                Rectangle dest = {
+                    (command.dest.x - camera.offset.x) * camera.zoom,
+                    (command.dest.y - camera.offset.y) * camera.zoom,
+                    command.dest.width * camera.zoom,
+                    command.dest.height * camera.zoom
+                };
+                DrawTexturePro(command.texture, command.source, dest, Vector2 {0, 0}, 0, command.tint);
+                break;
+            }
+            case TileCommand:
+                DrawTile(command.gid, Vector2 {command.dest.x, command.dest.y}, tilesets, camera, command.tint);
+                break;
+            case CustomCommand:
+                customs[command.custom]();
+                break;
+        }
+    }
+    Clear();
+}
+
+void RenderQueue::Clear() {
+    commands.clear();
+    keys.clear();
+    customs.clear();
+}
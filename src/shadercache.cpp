@@ -0,0 +1,193 @@
+#include "shadercache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "mapped.h"
+
+#if defined(_WIN32)
+    #define GL_API_CALL __stdcall
+#else
+    #define GL_API_CALL
+#endif
+
+// raylib doesn't wrap program binaries, so they come straight from the driver through GLFW
+#if !defined(PLATFORM_WEB)
+typedef void (*GLFWglproc)(void);
+extern "C" GLFWglproc glfwGetProcAddress(const char *procname);
+
+const unsigned int glVendor = 0x1F00;
+const unsigned int glRenderer = 0x1F01;
+const unsigned int glVersion = 0x1F02;
+const unsigned int glLinkStatus = 0x8B82;
+const unsigned int glProgramBinaryLength = 0x8741;
+const unsigned int glNumProgramBinaryFormats = 0x87FE;
+
+typedef const unsigned char *(GL_API_CALL *GetStringProc)(unsigned int name);
+typedef void (GL_API_CALL *GetIntegervProc)(unsigned int name, int *data);
+typedef unsigned int (GL_API_CALL *CreateProgramProc)(void);
+typedef void (GL_API_CALL *DeleteProgramProc)(unsigned int program);
+typedef void (GL_API_CALL *GetProgramivProc)(unsigned int program, unsigned int name, int *params);
+typedef void (GL_API_CALL *GetProgramBinaryProc)(unsigned int program, int bufSize, int *length, unsigned int *binaryFormat, void *binary);
+typedef void (GL_API_CALL *ProgramBinaryProc)(unsigned int program, unsigned int binaryFormat, const void *binary, int length);
+
+GetStringProc glGetStringProc;
+CreateProgramProc glCreateProgramProc;
+DeleteProgramProc glDeleteProgramProc;
+GetProgramivProc glGetProgramivProc;
+GetProgramBinaryProc glGetProgramBinaryProc;
+ProgramBinaryProc glProgramBinaryProc;
+#endif
+
+// From rlgl.h, which isn't part of the include folder
+const int maxShaderLocations = 32;     // RL_MAX_SHADER_LOCATIONS
+extern "C" unsigned int rlGetShaderIdDefault(void);
+
+// raylib's locations for a program it didn't link itself, the same ones LoadShaderFromMemory sets
+Shader WrapProgram(unsigned int program) {
+    Shader shader = {program, (int *) MemAlloc(maxShaderLocations * sizeof(int))};
+    for (int index = 0; index < maxShaderLocations; index++) shader.locs[index] = -1;
+
+    shader.locs[SHADER_LOC_VERTEX_POSITION] = GetShaderLocationAttrib(shader, "vertexPosition");
+    shader.locs[SHADER_LOC_VERTEX_TEXCOORD01] = GetShaderLocationAttrib(shader, "vertexTexCoord");
+    shader.locs[SHADER_LOC_VERTEX_TEXCOORD02] = GetShaderLocationAttrib(shader, "vertexTexCoord2");
+    shader.locs[SHADER_LOC_VERTEX_NORMAL] = GetShaderLocationAttrib(shader, "vertexNormal");
+    shader.locs[SHADER_LOC_VERTEX_TANGENT] = GetShaderLocationAttrib(shader, "vertexTangent");
+    shader.locs[SHADER_LOC_VERTEX_COLOR] = GetShaderLocationAttrib(shader, "vertexColor");
+    shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(shader, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_VIEW] = GetShaderLocation(shader, "matView");
+    shader.locs[SHADER_LOC_MATRIX_PROJECTION] = GetShaderLocation(shader, "matProjection");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocation(shader, "matModel");
+    shader.locs[SHADER_LOC_MATRIX_NORMAL] = GetShaderLocation(shader, "matNormal");
+    shader.locs[SHADER_LOC_COLOR_DIFFUSE] = GetShaderLocation(shader, "colDiffuse");
+    shader.locs[SHADER_LOC_MAP_DIFFUSE] = GetShaderLocation(shader, "texture0");
+    shader.locs[SHADER_LOC_MAP_SPECULAR] = GetShaderLocation(shader, "texture1");
+    shader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(shader, "texture2");
+    return shader;
+}
+
+// FNV-1a
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t index = 0; index < size; index++) {
+        hash = (hash ^ bytes[index]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+void ShaderCache::Init(const char *_folder) {
+    folder = _folder;
+    driver = "raylib " RAYLIB_VERSION;
+    binaries = false;
+
+#if !defined(PLATFORM_WEB)
+    glGetStringProc = (GetStringProc) glfwGetProcAddress("glGetString");
+    GetIntegervProc glGetIntegervProc = (GetIntegervProc) glfwGetProcAddress("glGetIntegerv");
+    glCreateProgramProc = (CreateProgramProc) glfwGetProcAddress("glCreateProgram");
+    glDeleteProgramProc = (DeleteProgramProc) glfwGetProcAddress("glDeleteProgram");
+    glGetProgramivProc = (GetProgramivProc) glfwGetProcAddress("glGetProgramiv");
+    glGetProgramBinaryProc = (GetProgramBinaryProc) glfwGetProcAddress("glGetProgramBinary");
+    glProgramBinaryProc = (ProgramBinaryProc) glfwGetProcAddress("glProgramBinary");
+    if (!glGetStringProc || !glGetIntegervProc || !glCreateProgramProc || !glDeleteProgramProc
+        || !glGetProgramivProc || !glGetProgramBinaryProc || !glProgramBinaryProc) return;
+
+    // Binaries only load on the exact driver that made them
+    for (unsigned int name : {glVendor, glRenderer, glVersion}) {
+        const unsigned char *text = glGetStringProc(name);
+        driver += "\n";
+        if (text != nullptr) driver += (const char *) text;
+    }
+
+    int formats = 0;
+    glGetIntegervProc(glNumProgramBinaryFormats, &formats);
+    if (formats <= 0) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+    binaries = !error;
+#endif
+}
+
+Shader ShaderCache::Load(const std::string &fragmentCode) {
+    double start = GetTime();
+    uint64_t key = Key(fragmentCode);
+
+    if (binaries) {
+        unsigned int program = LoadBinary(key);
+        if (program != 0) {
+            stats.cached++;
+            stats.cacheTime += GetTime() - start;
+            return WrapProgram(program);
+        }
+    }
+
+    Shader shader = LoadShaderFromMemory(0, fragmentCode.c_str());
+    if (binaries && shader.id != rlGetShaderIdDefault()) SaveBinary(key, shader.id);
+    stats.compiled++;
+    stats.compileTime += GetTime() - start;
+    return shader;
+}
+
+uint64_t ShaderCache::Key(const std::string &fragmentCode) {
+    uint64_t hash = HashBytes(0xcbf29ce484222325ull, driver.c_str(), driver.size() + 1);
+    return HashBytes(hash, fragmentCode.c_str(), fragmentCode.size());
+}
+
+std::string ShaderCache::PathOf(uint64_t key) {
+    return folder + "/" + TextFormat("%08x%08x", (unsigned int) (key >> 32), (unsigned int) key) + shaderCacheExtension;
+}
+
+unsigned int ShaderCache::LoadBinary(uint64_t key) {
+#if !defined(PLATFORM_WEB)
+    MappedFile file;
+    if (!file.Open(PathOf(key).c_str())) return 0;
+
+    ShaderCacheHeader header;
+    if (file.Size() < sizeof(header)) {
+        file.Close();
+        return 0;
+    }
+    memcpy(&header, file.Data(), sizeof(header));
+    if (memcmp(header.magic, shaderCacheMagic, 4) != 0 || header.version != shaderCacheVersion
+        || header.hash != key || header.size != file.Size() - sizeof(header)) {
+        file.Close();
+        return 0;
+    }
+
+    // A driver is free to reject its own binary, which then just compiles again
+    unsigned int program = glCreateProgramProc();
+    glProgramBinaryProc(program, header.format, file.Data() + sizeof(header), (int) header.size);
+    file.Close();
+
+    int linked = 0;
+    glGetProgramivProc(program, glLinkStatus, &linked);
+    if (linked) return program;
+    glDeleteProgramProc(program);
+#endif
+    return 0;
+}
+
+// raylib links without GL_PROGRAM_BINARY_RETRIEVABLE_HINT, drivers that want it give back an
+// empty binary and those programs are compiled every launch
+void ShaderCache::SaveBinary(uint64_t key, unsigned int program) {
+#if !defined(PLATFORM_WEB)
+    int length = 0;
+    glGetProgramivProc(program, glProgramBinaryLength, &length);
+    if (length <= 0) return;
+
+    std::vector<unsigned char> binary(length);
+    ShaderCacheHeader header = {};
+    glGetProgramBinaryProc(program, length, &length, &header.format, binary.data());
+    if (length <= 0) return;
+
+    memcpy(header.magic, shaderCacheMagic, 4);
+    header.version = shaderCacheVersion;
+    header.hash = key;
+    header.size = (uint32_t) length;
+
+    std::ofstream out(PathOf(key), std::ios::binary);
+    if (!out) return;
+    out.write((const char *) &header, sizeof(header));
+    out.write((const char *) binary.data(), length);
+#endif
+}
@@ -88,6 +88,7 @@ std::string getPanelName(Panel panel);
 
 void LoadShop() {
     Image sourceImage = LoadImageFromTexture(GetTexture(Textures::gui));
+    ImageCrop(&sourceImage, GetTextureRect(Textures::gui));
     shopBg = LoadTextureFromImage(shopBorder.GetImage(60 * 16, 42 * 16, scale, sourceImage));
     panelBtnLight = LoadTextureFromImage(buttonBorderLight.GetImage(60 * scale, 20 * scale, scale, sourceImage));
     panelBtnMidDark = LoadTextureFromImage(buttonBorderMidDark.GetImage(60 * scale, 20 * scale, scale, sourceImage));
@@ -96,7 +97,7 @@ void LoadShop() {
 }
 
 void InitShop() {
-    previewTractor.Init(0, Camera2D {{0, 0}, {0, 0}, 0, scale}, 116);
+    previewTractor.Init(GetScreenWidth() / scale, Camera2D {{0, 0}, {0, 0}, 0, scale}, 116);
     shopFadeIn.timer = 0;
     localCoins = -1;
 }
@@ -141,12 +142,12 @@ void UpdateShop(GameData &game, int bgOpacity) {
 
     Rectangle dest = {shopStart.x + (float) shopBg.width - 32 * scale, shopStart.y + 16 * scale, 16 * scale, 16 * scale};
     if (CheckCollisionPointRec(GetMousePosition(), dest)) {
-        DrawTexturePro(GetTexture(Textures::gui), {48, 16, 16, 16}, dest, {0, 0}, 0, {255, 255, 255, alpha});
+        DrawTexturePro(GetTexture(Textures::gui), GetSourceRect(Textures::gui, {48, 16, 16, 16}), dest, {0, 0}, 0, {255, 255, 255, alpha});
         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             setShopStatus(false);
         }
     } else {
-        DrawTexturePro(GetTexture(Textures::gui), {48, 0, 16, 16}, dest, {0, 0}, 0, {255, 255, 255, alpha});
+        DrawTexturePro(GetTexture(Textures::gui), GetSourceRect(Textures::gui, {48, 0, 16, 16}), dest, {0, 0}, 0, {255, 255, 255, alpha});
     }
     
     // Draw Buttons
@@ -225,7 +226,7 @@ void DrawUpgrades(Vector2 shopStart, GameData &game) {
         Rectangle source = {(float) 80 * upgradeIndex, 48, 80, 64};
         
         // Icon
-        DrawTexturePro(GetTexture(Textures::gui), source, {dest.x, dest.y + 64, source.width * scale, source.height * scale}, {0, 0}, 0, white);
+        DrawTexturePro(GetTexture(Textures::gui), GetSourceRect(Textures::gui, source), {dest.x, dest.y + 64, source.width * scale, source.height * scale}, {0, 0}, 0, white);
 
         // Progress Bar
         int width = 64;
@@ -295,12 +296,11 @@ void DrawColors(Vector2 shopStart, GameData &game) {
         {viewPanelPos.x + borderSize, viewPanelPos.y + borderSize, (float) previewPanel.width - borderSize * 2, (float) previewPanel.height - borderSize * 2}, {0, 0}, 0, WHITE);
 
     // Tractor
-    Camera2D cam = Camera2D {{16, 0}, {0, 0}, 0, 3};
-    BeginMode2D(cam);
-        previewTractor.rect.y = (shopStart.y + 213) / cam.zoom;
-        previewTractor.color = game.colors[game.selectedColor];
-        previewTractor.Draw(cam, true);
-    EndMode2D();
+    Camera2D cam = Camera2D {{-16.0f / 3, 0}, {0, 0}, 0, 3};   // Offset is in world units for toScreenPos, 16 pixels to the right
+    previewTractor.rect.y = (shopStart.y + 213) / cam.zoom;
+    previewTractor.color = game.colors[game.selectedColor];
+    previewTractor.Draw(GetSpriteBatch(), cam, 1, PreviewLayer);
+    GetSpriteBatch().Flush();
     
     // Colors 
     float y = viewPanelPos.y + previewPanel.height + 8;
@@ -368,12 +368,11 @@ void DrawBackground(Vector2 shopStart, GameData &game) {
         {viewPanelPos.x + borderSize, viewPanelPos.y + borderSize, (float) previewPanel.width - borderSize * 2, (float) previewPanel.height - borderSize * 2}, {0, 0}, 0, WHITE);
 
     // Tractor
-    Camera2D cam = Camera2D {{16, 0}, {0, 0}, 0, 3};
-    BeginMode2D(cam);
-        previewTractor.rect.y = (shopStart.y + 213) / cam.zoom;
-        previewTractor.color = game.colors[game.selectedColor];
-        previewTractor.Draw(cam, true);
-    EndMode2D();
+    Camera2D cam = Camera2D {{-16.0f / 3, 0}, {0, 0}, 0, 3};   // Offset is in world units for toScreenPos, 16 pixels to the right
+    previewTractor.rect.y = (shopStart.y + 213) / cam.zoom;
+    previewTractor.color = game.colors[game.selectedColor];
+    previewTractor.Draw(GetSpriteBatch(), cam, 1, PreviewLayer);
+    GetSpriteBatch().Flush();
     
     // Options 
     float y = viewPanelPos.y + previewPanel.height + 8;
@@ -434,24 +433,28 @@ void DrawEffects(Vector2 shopStart, GameData &game) {
     for (int index = 0; index < 13; index++) {
         Vector2 pos = {(index % 2 == 0 ? (shopStart.x + 118) : (shopStart.x + shopBg.width / 2)), (float) (y + (font.height + 2) * 4 * std::floor(index / 2))};
 
-        if (index == (int) game.selectedShader) {
+        // Effects stack, None is lit when nothing is on
+        bool selected = index == None ? game.selectedEffects == 0 : HasEffect(game.selectedEffects, (Shaders) index);
+        if (unlocked && index != None) WarmEffects(game.selectedEffects ^ EffectBit((Shaders) index));
+        if (selected) {
             font.Render(names[index], pos, 4, Cwhite);
         } else {
             font.Render(names[index], pos, 4, Cgrey);
+        }
 
-            if (CheckCollisionPointRec(GetMousePosition(), {pos.x, pos.y, font.Measure(names[index]) * 4.0f, font.height * 4}) && unlocked) {
-                if (shaderTransitions[index] < 10)
-                    shaderTransitions[index]++;
-                font.Render(names[index], pos, 4, ColorAlpha(CgreyLight, (float) shaderTransitions[index] / 10));
-                hoverIndex = index;
-            } else if (shaderTransitions[index] > 0) {
-                shaderTransitions[index]--;
-            }
+        if (CheckCollisionPointRec(GetMousePosition(), {pos.x, pos.y, font.Measure(names[index]) * 4.0f, font.height * 4}) && unlocked) {
+            if (shaderTransitions[index] < 10)
+                shaderTransitions[index]++;
+            if (!selected) font.Render(names[index], pos, 4, ColorAlpha(CgreyLight, (float) shaderTransitions[index] / 10));
+            hoverIndex = index;
+        } else if (shaderTransitions[index] > 0) {
+            shaderTransitions[index]--;
         }
     }
 
+    // Clicking an effect turns it on or off, None turns them all off
     if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && hoverIndex != -1) {
-        SetNextShader((Shaders) hoverIndex);
+        SetNextEffects(hoverIndex == None ? 0 : game.selectedEffects ^ EffectBit((Shaders) hoverIndex));
     }
 
     if (!unlocked) {
@@ -525,6 +528,11 @@ bool DrawShopLocked(Vector2 shopStart, Panel panelName, int price, GameData &gam
     return isPressed;
 }
 
+void StepShop() {
+    if (shopOpen)
+        previewTractor.Animate();
+}
+
 void setShopPanel(Panel newPanel) {
     currentPanel = newPanel;
 }
@@ -0,0 +1,301 @@
+#include "tmx.h"
+#include <cstdlib>
+#include <cstring>
+
+static inline bool IsWhitespace(int character) {
+    return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+}
+
+static inline bool IsNameCharacter(int character) {
+    return character != EOF && !IsWhitespace(character) && character != '=' && character != '>' && character != '/'
+        && character != '<' && character != '"' && character != '\'';
+}
+
+const char *TmxElement::Attribute(const char *attribute, const char *fallback) const {
+    for (const auto &[key, value] : attributes) {
+        if (key == attribute) return value.c_str();
+    }
+    return fallback;
+}
+
+int TmxElement::IntAttribute(const char *attribute, int fallback) const {
+    const char *value = Attribute(attribute);
+    return value ? atoi(value) : fallback;
+}
+
+float TmxElement::FloatAttribute(const char *attribute, float fallback) const {
+    const char *value = Attribute(attribute);
+    return value ? (float) atof(value) : fallback;
+}
+
+bool TmxElement::BoolAttribute(const char *attribute, bool fallback) const {
+    const char *value = Attribute(attribute);
+    if (value == nullptr) return fallback;
+    return strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+}
+
+const TmxElement *TmxElement::FirstChild(const char *childName) const {
+    for (const TmxElement &child : children) {
+        if (child.name == childName) return &child;
+    }
+    return nullptr;
+}
+
+TmxReader::~TmxReader() {
+    Close();
+}
+
+bool TmxReader::Open(const char *path) {
+    Close();
+    file = fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    buffer.resize(tmxBlockSize);
+    position = 0;
+    length = 0;
+    depth = 0;
+    emptyElement = false;
+    failed = false;
+    return true;
+}
+
+void TmxReader::Close() {
+    if (file != nullptr) fclose(file);
+    file = nullptr;
+}
+
+bool TmxReader::Refill() {
+    if (file == nullptr) return false;
+    length = (int) fread(buffer.data(), 1, buffer.size(), file);
+    position = 0;
+    return length > 0;
+}
+
+TmxReader::Event TmxReader::Fail() {
+    failed = true;
+    Close();
+    return Error;
+}
+
+TmxReader::Event TmxReader::Next() {
+    if (failed) return Error;
+
+    if (emptyElement) {
+        emptyElement = false;
+        depth--;
+        return EndElement;
+    }
+
+    while (true) {
+        text.clear();
+        int character = Peek();
+        if (character == EOF) return depth == 0 ? EndOfFile : Fail();
+
+        if (character != '<') {
+            // Copy runs without markup straight out of the block
+            while (text.size() < (size_t) tmxBlockSize) {
+                character = Peek();
+                if (character == EOF || character == '<') break;
+
+                if (character == '&') {
+                    Get();
+                    if (!ReadEntity(text)) return Fail();
+                    continue;
+                }
+
+                int start = position;
+                while (position < length && buffer[position] != '<' && buffer[position] != '&') position++;
+                text.append(buffer.data() + start, position - start);
+            }
+            return Text;
+        }
+
+        Get();
+        character = Peek();
+
+        if (character == '?') {
+            if (!SkipPast("?>")) return Fail();
+            continue;
+        }
+
+        if (character == '!') {
+            Get();
+            if (Peek() == '-') {
+                if (!Expect("--") || !SkipPast("-->")) return Fail();
+                continue;
+            }
+            if (Peek() == '[') {
+                if (!Expect("[CDATA[")) return Fail();
+                while (true) {
+                    character = Get();
+                    if (character == EOF) return Fail();
+                    text.push_back((char) character);
+                    if (text.size() >= 3 && text.compare(text.size() - 3, 3, "]]>") == 0) break;
+                }
+                text.resize(text.size() - 3);
+                return Text;
+            }
+            // A doctype, Tiled doesn't write any but they're harmless
+            if (!SkipPast(">")) return Fail();
+            continue;
+        }
+
+        if (character == '/') {
+            Get();
+            if (!ReadName(element.name)) return Fail();
+            SkipWhitespace();
+            if (Get() != '>' || depth == 0) return Fail();
+            depth--;
+            return EndElement;
+        }
+
+        element.attributes.clear();
+        element.children.clear();
+        element.text.clear();
+        if (!ReadName(element.name)) return Fail();
+
+        while (true) {
+            SkipWhitespace();
+            character = Get();
+            if (character == '>') break;
+            if (character == '/') {
+                if (Get() != '>') return Fail();
+                emptyElement = true;
+                break;
+            }
+            if (character == EOF) return Fail();
+            position--;
+
+            std::pair<std::string, std::string> attribute;
+            if (!ReadName(attribute.first)) return Fail();
+            SkipWhitespace();
+            if (Get() != '=') return Fail();
+            SkipWhitespace();
+
+            int quote = Get();
+            if ((quote != '"' && quote != '\'') || !ReadAttributeValue(quote, attribute.second)) return Fail();
+            element.attributes.push_back(std::move(attribute));
+        }
+
+        depth++;
+        return StartElement;
+    }
+}
+
+bool TmxReader::FindElement(const char *name) {
+    while (true) {
+        Event event = Next();
+        if (event == EndOfFile || event == Error) return false;
+        if (event == StartElement && element.name == name) return true;
+    }
+}
+
+bool TmxReader::NextChild(int parentDepth) {
+    while (true) {
+        Event event = Next();
+        if (event == EndOfFile || event == Error) return false;
+        if (event == StartElement && depth == parentDepth + 1) return true;
+        if (event == EndElement && depth < parentDepth) return false;
+    }
+}
+
+TmxElement TmxReader::ReadElement() {
+    TmxElement result = element;
+
+    while (true) {
+        Event event = Next();
+        if (event == StartElement) {
+            result.children.push_back(ReadElement());
+        } else if (event == Text) {
+            result.text += text;
+        } else {
+            if (event != EndElement) failed = true;
+            return result;
+        }
+    }
+}
+
+void TmxReader::SkipWhitespace() {
+    while (IsWhitespace(Peek())) Get();
+}
+
+bool TmxReader::Expect(const char *expected) {
+    for (const char *character = expected; *character != '\0'; character++) {
+        if (Get() != *character) return false;
+    }
+    return true;
+}
+
+bool TmxReader::SkipPast(const char *terminator) {
+    int terminatorLength = (int) strlen(terminator);
+    std::string recent;
+    while (true) {
+        int character = Get();
+        if (character == EOF) return false;
+
+        recent.push_back((char) character);
+        if ((int) recent.size() > terminatorLength) recent.erase(recent.begin());
+        if (recent == terminator) return true;
+    }
+}
+
+bool TmxReader::ReadName(std::string &name) {
+    name.clear();
+    while (IsNameCharacter(Peek())) name.push_back((char) Get());
+    return !name.empty();
+}
+
+// Called after the '&', appends the character the entity stands for
+bool TmxReader::ReadEntity(std::string &out) {
+    std::string entity;
+    while (true) {
+        int character = Get();
+        if (character == ';') break;
+        if (character == EOF || entity.size() > 8) return false;
+        entity.push_back((char) character);
+    }
+
+    if (entity == "amp") out.push_back('&');
+    else if (entity == "lt") out.push_back('<');
+    else if (entity == "gt") out.push_back('>');
+    else if (entity == "quot") out.push_back('"');
+    else if (entity == "apos") out.push_back('\'');
+    else if (entity.size() > 1 && entity[0] == '#') {
+        unsigned long code = entity[1] == 'x' ? strtoul(entity.c_str() + 2, nullptr, 16) : strtoul(entity.c_str() + 1, nullptr, 10);
+
+        // Encode the code point as UTF-8
+        if (code < 0x80) {
+            out.push_back((char) code);
+        } else if (code < 0x800) {
+            out.push_back((char) (0xc0 | code >> 6));
+            out.push_back((char) (0x80 | (code & 0x3f)));
+        } else if (code < 0x10000) {
+            out.push_back((char) (0xe0 | code >> 12));
+            out.push_back((char) (0x80 | (code >> 6 & 0x3f)));
+            out.push_back((char) (0x80 | (code & 0x3f)));
+        } else {
+            out.push_back((char) (0xf0 | code >> 18));
+            out.push_back((char) (0x80 | (code >> 12 & 0x3f)));
+            out.push_back((char) (0x80 | (code >> 6 & 0x3f)));
+            out.push_back((char) (0x80 | (code & 0x3f)));
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool TmxReader::ReadAttributeValue(int quote, std::string &value) {
+    value.clear();
+    while (true) {
+        int character = Get();
+        if (character == EOF || character == '<') return false;
+        if (character == quote) return true;
+
+        if (character == '&') {
+            if (!ReadEntity(value)) return false;
+        } else {
+            value.push_back((char) character);
+        }
+    }
+}
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <cmath>
 #include "tractor.h"
 #include "utils.h"
 
+const int cartSheetWidth = 48;
 const int totalRainbowColors = 6;
 Color rainbowColors[totalRainbowColors] {
     {230, 55, 55, 255},
@@ -25,18 +27,31 @@ void Tractor::Init(int sw, Camera2D cam, int startY) {
     isMoving = false;
     isLongWagon = false;
     isRainbow = false;
+    cartWheelBump = false;
+    wheelLargeBump = false;
+    wheelSmallBump = false;
     color = Color {255, 255, 255, 255};
     
     smokeParticleTimer = 0;
     smokeParticlces.clear();
 
     momentum = {0, 0};
-    rect = Rectangle {cam.offset.x + (GetScreenWidth() / cam.zoom) / 2 - 16, (float) startY - 32, 32, 32};
+    rect = Rectangle {cam.offset.x + (float) sw / 2 - 16, (float) startY - 32, 32, 32};
     hitbox = Rectangle {3, 11, 27, 21};
     cartX = rect.x + rect.width / 2 - (facingRight ? cartDesiredDis : -cartDesiredDis);
+    StorePrevious();
 }
 
-void Tractor::Update(Camera2D cam, GameData &game, bool canMove, float customSpeed) {
+void Tractor::StorePrevious() {
+    prevRect = rect;
+    prevCartX = cartX;
+
+    for (SmokeParticle &particle : smokeParticlces) {
+        particle.prevPos = particle.pos;
+    }
+}
+
+void Tractor::Update(Camera2D cam, GameData &game, TickInput input, int sw, bool canMove, float customSpeed) {
     float speed;
     if (customSpeed == -1)
         speed = game.speedUpgrade.values[game.speedUpgrade.unlocked];
@@ -49,13 +64,13 @@ void Tractor::Update(Camera2D cam, GameData &game, bool canMove, float customSpe
     if (canMove) {
         isMoving = false;
 
-        bool keyRight = (IsKeyDown(KEY_D) && !IsKeyDown(KEY_A)) || (IsKeyDown(KEY_RIGHT) && !IsKeyDown(KEY_LEFT));
-        bool keyLeft = (IsKeyDown(KEY_A) && !IsKeyDown(KEY_D)) || (IsKeyDown(KEY_LEFT) && !IsKeyDown(KEY_RIGHT));
+        bool keyRight = input.right;
+        bool keyLeft = input.left;
 
         // Movement
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && !(keyRight || keyLeft)) {
-            int mx = GetMousePosition().x;
-            if ((mx > (rect.x + rect.width / 2 + 8) * cam.zoom || mx > GetScreenWidth() - 128) && mx > 128) {
+        if (input.pointerDown && !(keyRight || keyLeft)) {
+            int mx = input.pointerX;
+            if ((mx > (rect.x + rect.width / 2 + 8) * cam.zoom || mx > sw * cam.zoom - 128) && mx > 128) {
                 keyRight = true;
             } else if (mx < (rect.x + rect.width / 2 - 8) * cam.zoom || mx < 128) {
                 keyLeft = true;
@@ -91,13 +106,13 @@ void Tractor::Update(Camera2D cam, GameData &game, bool canMove, float customSpe
         }
 
         // Squish
-        if (IsKeyDown(KEY_W) && !IsKeyDown(KEY_S)) {
+        if (input.up) {
             if (ySquish > -5) {
                 ySquish -= 0.75;
             } else {
                 ySquish = -5;
             }
-        } else if (IsKeyDown(KEY_S) && !IsKeyDown(KEY_W)) {
+        } else if (input.down) {
             if (ySquish < 5) {
                 ySquish += 0.75;
             } else {
@@ -111,8 +126,8 @@ void Tractor::Update(Camera2D cam, GameData &game, bool canMove, float customSpe
     }
 
     if (facingRight) {
-        if (rect.x + hitbox.x + hitbox.width > cam.offset.x + GetScreenWidth() / cam.zoom) {
-            rect.x = (cam.offset.x + GetScreenWidth() / cam.zoom) - hitbox.width - hitbox.x;
+        if (rect.x + hitbox.x + hitbox.width > cam.offset.x + sw) {
+            rect.x = (cam.offset.x + sw) - hitbox.width - hitbox.x;
             if (momentum.x >= speed) momentum.x = -momentum.x;
         } 
     } else {
@@ -151,104 +166,237 @@ void Tractor::Update(Camera2D cam, GameData &game, bool canMove, float customSpe
     // }
 }
 
-void Tractor::Draw(Camera2D cam, bool updateAnimations) {
-    Texture2D &cartTexture = GetTexture(Textures::cart);
-    Rectangle cartDest = Rectangle {cartX - cartTexture.width / 2, rect.y + 10, (float) cartTexture.width, 32};
-    Rectangle cartWheelDest = {cartDest.x + 16, cartDest.y + 9, 16, 16};
-    
-    Vector2 lineStart = {(float) (facingRight ? cartX + 8 : cartX - 8), rect.y + 23};
-    Vector2 lineEnd = {facingRight ? rect.x + 8 : rect.x + rect.width - 8, rect.y + 22};
-    
-    if (lineStart.x > lineEnd.x) {
-        Vector2 temp = lineStart;
-        lineStart = lineEnd;
-        lineEnd = temp;
-    }
-
-    if (isMoving) {
-        if (runningAnimationTimer % 15 < 2 && std::abs(rect.x + rect.width / 2 - cartX) > 24) {
-            cartDest.y -= 1;
-        }
-
-        if (GetRandomValue(0, 3) == 0 && updateAnimations) {
-            cartWheelDest.y -= 1;
-        }
-    }
-
-    Vector2 wheelLargePos = facingRight ? Vector2 {2, 18} : Vector2 {14, 18};
-    Vector2 wheelSmallPos = facingRight ? Vector2 {17, 20} : Vector2 {-1, 20};
+void Tractor::Animate() {
     int waitDur = 20;
     int moveDur = 8;
-    Rectangle tractorBackDest = rect;
-    Rectangle tractorFrontDest = rect;
-    Rectangle wheelLargeDest = {rect.x + wheelLargePos.x , rect.y + wheelLargePos.y, 16, 16};
-    Rectangle wheelSmallDest = {rect.x + wheelSmallPos.x , rect.y + wheelSmallPos.y, 16, 16};
 
     if (isMoving) {
         idleAnimationTimer = 0;
+        runningAnimationTimer++;
 
-        if (updateAnimations)
-            runningAnimationTimer++;
-
-        if (runningAnimationTimer % (moveDur * 2) < moveDur) {
-            tractorBackDest.y -= 1;
-            tractorFrontDest.y -= 1;
-        }
-
-        if (runningAnimationTimer % (waitDur * 2 + moveDur * 2) < waitDur + moveDur) {
-            tractorBackDest.x += 1;
-            tractorFrontDest.x += 1;
-            tractorBackDest.width -= 2;
-            tractorFrontDest.width -= 2;
-        }
-
-        if ((runningAnimationTimer + 10) % waitDur < moveDur || runningAnimationTimer % (moveDur * 2) < moveDur) {
-            tractorBackDest.height += 1;
-            tractorFrontDest.height += 1;
-        }
-
-        if (GetRandomValue(0, 2) == 0 && updateAnimations) {
+        cartWheelBump = GetRandomValue(0, 3) == 0;
+        wheelLargeBump = false;
+        wheelSmallBump = false;
+        if (GetRandomValue(0, 2) == 0) {
             if (GetRandomValue(0, 2) == 0) {
-                wheelLargeDest.y -= 1;
+                wheelLargeBump = true;
             } else {
-                wheelSmallDest.y -= 1;
+                wheelSmallBump = true;
             }
         }
-
     } else {
         runningAnimationTimer = 0;
-
-        if (updateAnimations)
-            idleAnimationTimer++;
+        idleAnimationTimer++;
 
         if (idleAnimationTimer > moveDur * 2 + waitDur * 2) {
             idleAnimationTimer = 0;
         }
 
+        cartWheelBump = false;
+        wheelLargeBump = false;
+        wheelSmallBump = false;
+    }
+
+    if (flipTimer) {
+        flipTimer--;
+    }
+
+    if (isRainbow) {
+        rainbowTimer++;
+        if (rainbowTimer >= totalRainbowColors * 20)
+            rainbowTimer = 0;
+    }
+}
+
+// Body and cart variants, each cell holds one whole pose with some room for what sticks out.
+// Cell coordinates are relative to the tractor rect and to the top left of the cart
+const Rectangle bodyCell = {-1, -2, 34, 38};
+const Rectangle cartCell = {0, -1, cartSheetWidth, 33};
+const int bodyPoses = 3 * 2 * 2 * 3;
+const int bodyColumns = 12;
+
+class TractorSprites {
+public:
+    RenderTexture2D texture = {};
+    Color color = {};
+    bool built = false;
+
+    // One pass over every pose, only when the color is new
+    void Build(Color _color) {
+        if (built && ColorToInt(color) == ColorToInt(_color)) return;
+
+        int bodyRows = (bodyPoses * 2 + bodyColumns - 1) / bodyColumns;
+        int width = (int) std::max(bodyCell.width * bodyColumns, cartCell.width * 8);
+        int height = (int) (bodyCell.height * bodyRows + cartCell.height);
+        if (texture.id == 0 || texture.texture.width != width || texture.texture.height != height) {
+            if (texture.id != 0) UnloadRenderTexture(texture);
+            texture = LoadRenderTexture(width, height);
+        }
+
+        // Every part is either opaque or clear, so drawing them over a clear target keeps plain alpha
+        BeginTextureMode(texture);
+            ClearBackground(BLANK);
+            for (int facing = 0; facing < 2; facing++) {
+                for (int pose = 0; pose < bodyPoses; pose++) {
+                    TractorPose tractorPose = {pose / 12, (pose / 6) % 2 == 1, (pose / 3) % 2 == 1, pose % 3, false, false};
+                    Rectangle cell = BodySource(facing == 1, tractorPose);
+                    DrawBody(Vector2 {cell.x - bodyCell.x, cell.y - bodyCell.y}, facing == 1, tractorPose, _color);
+                }
+            }
+            for (int cart = 0; cart < 8; cart++) {
+                TractorPose tractorPose = {0, false, false, 0, (cart / 2) % 2 == 1, cart % 2 == 1};
+                Rectangle cell = CartSource(cart / 4 == 1, tractorPose);
+                DrawCart(Vector2 {cell.x - cartCell.x, cell.y - cartCell.y}, cart / 4 == 1, tractorPose);
+            }
+        EndTextureMode();
+
+        color = _color;
+        built = true;
+    }
+
+    void Unload() {
+        if (texture.id != 0) UnloadRenderTexture(texture);
+        texture = RenderTexture2D {};
+        built = false;
+    }
+
+    Rectangle BodySource(bool facingRight, TractorPose pose) {
+        int index = (facingRight ? bodyPoses : 0) + ((pose.bob * 2 + pose.narrow) * 2 + pose.tall) * 3 + pose.wheelBump;
+        return Rectangle {(index % bodyColumns) * bodyCell.width, (index / bodyColumns) * bodyCell.height, bodyCell.width, bodyCell.height};
+    }
+
+    Rectangle CartSource(bool longWagon, TractorPose pose) {
+        int index = (longWagon ? 4 : 0) + pose.cartUp * 2 + pose.cartWheelBump;
+        int bodyRows = (bodyPoses * 2 + bodyColumns - 1) / bodyColumns;
+        return Rectangle {index * cartCell.width, bodyRows * bodyCell.height, cartCell.width, cartCell.height};
+    }
+
+    // Where the parts go at zoom 1 with the tractor rect's corner at origin, same as Tractor::Draw
+    static void DrawBody(Vector2 origin, bool facingRight, TractorPose pose, Color tint) {
+        float flip = facingRight ? 1 : -1;
+        Rectangle body = {origin.x + pose.narrow, origin.y - pose.bob, 32.0f - pose.narrow * 2, 32.0f + pose.tall};
+        Vector2 wheelLargePos = facingRight ? Vector2 {2, 18} : Vector2 {14, 18};
+        Vector2 wheelSmallPos = facingRight ? Vector2 {17, 20} : Vector2 {-1, 20};
+        Rectangle wheelLarge = {origin.x + wheelLargePos.x, origin.y + wheelLargePos.y - (pose.wheelBump == 1), 16, 16};
+        Rectangle wheelSmall = {origin.x + wheelSmallPos.x, origin.y + wheelSmallPos.y - (pose.wheelBump == 2), 16, 16};
+
+        Texture2D &tractor = GetTexture(Textures::tractor);
+        DrawTexturePro(tractor, GetSourceRect(Textures::tractor, {0, 64, 32 * flip, 32}), body, {0, 0}, 0, WHITE);
+        DrawTexturePro(GetTexture(Textures::wheelLarge), GetSourceRect(Textures::wheelLarge, {0, 0, 16 * flip, 16}), wheelLarge, {0, 0}, 0, WHITE);
+        DrawTexturePro(GetTexture(Textures::wheelSmall), GetSourceRect(Textures::wheelSmall, {0, 0, 16 * flip, 16}), wheelSmall, {0, 0}, 0, WHITE);
+        DrawTexturePro(tractor, GetSourceRect(Textures::tractor, {0, 0, 32 * flip, 32}), body, {0, 0}, 0, tint);
+        DrawTexturePro(tractor, GetSourceRect(Textures::tractor, {0, 32, 32 * flip, 32}), body, {0, 0}, 0, WHITE);
+    }
+
+    static void DrawCart(Vector2 origin, bool longWagon, TractorPose pose) {
+        Rectangle cart = {origin.x, origin.y - pose.cartUp, cartSheetWidth, 32};
+        Rectangle wheel = {origin.x + 16, origin.y + 9 - pose.cartWheelBump, 16, 16};
+        DrawTexturePro(GetTexture(Textures::wheelSmall), GetSourceRect(Textures::wheelSmall, {0, 0, 16, 16}), wheel, {0, 0}, 0, WHITE);
+        DrawTexturePro(GetTexture(Textures::cart), GetSourceRect(Textures::cart, {0, (float) (longWagon ? 32 : 0), cartSheetWidth, 32}), cart, {0, 0}, 0, WHITE);
+    }
+};
+
+TractorSprites tractorSprites;
+
+void PrepareTractorSprites(Color color) {
+    tractorSprites.Build(color);
+}
+
+void UnloadTractorSprites() {
+    tractorSprites.Unload();
+}
+
+// The discrete part of the animation, the only part the pre-rendered sprites cover
+TractorPose Tractor::GetPose(float cartX, float rectX) {
+    int waitDur = 20;
+    int moveDur = 8;
+    TractorPose pose = {};
+
+    if (isMoving) {
+        pose.cartUp = runningAnimationTimer % 15 < 2 && std::abs(rectX + rect.width / 2 - cartX) > 24;
+        pose.cartWheelBump = cartWheelBump;
+
+        if (runningAnimationTimer % (moveDur * 2) < moveDur) pose.bob = 1;
+        pose.narrow = runningAnimationTimer % (waitDur * 2 + moveDur * 2) < waitDur + moveDur;
+        pose.tall = (runningAnimationTimer + 10) % waitDur < moveDur || runningAnimationTimer % (moveDur * 2) < moveDur;
+
+        if (wheelLargeBump) {
+            pose.wheelBump = 1;
+        } else if (wheelSmallBump) {
+            pose.wheelBump = 2;
+        }
+    } else {
         if (idleAnimationTimer <= moveDur) {
-            tractorBackDest.y -= 1;
-            tractorFrontDest.y -= 1;
+            pose.bob = 1;
         } else if (idleAnimationTimer <= moveDur + waitDur) {
-            tractorBackDest.y -= 2;
-            tractorFrontDest.y -= 2;
+            pose.bob = 2;
         } else if (idleAnimationTimer <= moveDur * 2 + waitDur) {
-            tractorBackDest.y -= 1;
-            tractorFrontDest.y -= 1;
+            pose.bob = 1;
         }
 
-        if (idleAnimationTimer <= moveDur * 2 || idleAnimationTimer > moveDur + waitDur * 2) {
-            tractorBackDest.x += 1;
-            tractorFrontDest.x += 1;
-            tractorBackDest.width -= 2;
-            tractorFrontDest.width -= 2;
-        }
+        pose.narrow = idleAnimationTimer <= moveDur * 2 || idleAnimationTimer > moveDur + waitDur * 2;
+        pose.tall = idleAnimationTimer > moveDur * 1.5 && idleAnimationTimer < waitDur;
+    }
+    return pose;
+}
 
-        if (idleAnimationTimer > moveDur * 1.5 && idleAnimationTimer < waitDur) {
-            tractorBackDest.height += 1;
-            tractorFrontDest.height += 1;
-        }
+void Tractor::Draw(SpriteBatch &batch, Camera2D cam, float alpha, int layer) {
+    Rectangle rect = {Interpolate(prevRect.x, this->rect.x, alpha), Interpolate(prevRect.y, this->rect.y, alpha), this->rect.width, this->rect.height};
+    float cartX = Interpolate(prevCartX, this->cartX, alpha);
+    TractorPose pose = GetPose(cartX, rect.x);
+    SpriteHandles &handles = GetSpriteHandles();
+
+    Rectangle cartRect = GetTextureRect(Textures::cart);
+    Vector2 cartPos = {cartX - cartRect.width / 2, rect.y + 10};
+    
+    Vector2 lineStart = {(float) (facingRight ? cartX + 8 : cartX - 8), rect.y + 23};
+    Vector2 lineEnd = {facingRight ? rect.x + 8 : rect.x + rect.width - 8, rect.y + 22};
+    
+    if (lineStart.x > lineEnd.x) {
+        Vector2 temp = lineStart;
+        lineStart = lineEnd;
+        lineEnd = temp;
+    }
+
+    // Parts overlap each other so each one gets its own layer, positions are snapped like DrawTexture and DrawRectangle did
+    Rectangle haloRect = GetTextureRect(Textures::halo);
+    Vector2 haloPos = {rect.x + rect.width / 2 - haloRect.width / 2, rect.y + rect.height / 2 - haloRect.height / 2};
+    Rectangle haloDest = {(float) (int) haloPos.x, (float) (int) haloPos.y, haloRect.width, haloRect.height};
+    Rectangle lineDest = {(float) (int) lineStart.x, (float) (int) lineStart.y, (float) ((int) lineEnd.x - (int) lineStart.x), 2};
+
+    batch.Draw(layer, GetTexture(handles.halo), haloRect, toScreenPos(haloDest, cam), Color {252, 121, 20, 30});
+    batch.DrawRect(layer + 1, toScreenPos(lineDest, cam), Color {95, 52, 54, 255});
+
+    // Settled poses are one quad each for the cart and the body. Squish, the turn and the rainbow
+    // are in between poses, so those frames put the tractor together from its parts
+    TractorSprites &sprites = tractorSprites;
+    if (sprites.built && ColorToInt(sprites.color) == ColorToInt(color) && !isRainbow && flipTimer == 0 && ySquish == 0
+        && cartRect.width == cartSheetWidth) {
+        Rectangle cartSource = sprites.CartSource(isLongWagon, pose);
+        Rectangle bodySource = sprites.BodySource(facingRight, pose);
+        Rectangle cartDest = {cartPos.x + cartCell.x, cartPos.y + cartCell.y, cartCell.width, cartCell.height};
+        Rectangle bodyDest = {rect.x + bodyCell.x, rect.y + bodyCell.y, bodyCell.width, bodyCell.height};
+
+        // Render textures are stored upside down
+        Texture2D &texture = sprites.texture.texture;
+        cartSource = {cartSource.x, texture.height - cartSource.y - cartSource.height, cartSource.width, -cartSource.height};
+        bodySource = {bodySource.x, texture.height - bodySource.y - bodySource.height, bodySource.width, -bodySource.height};
+        batch.Draw(layer + 3, texture, cartSource, toScreenPos(cartDest, cam), WHITE);
+        batch.Draw(layer + 4, texture, bodySource, toScreenPos(bodyDest, cam), WHITE);
+        return;
     }
 
+    Texture2D &cartTexture = GetTexture(handles.cart);
+    Rectangle cartDest = Rectangle {cartPos.x, cartPos.y - pose.cartUp, cartRect.width, 32};
+    Rectangle cartWheelDest = {cartPos.x + 16, cartPos.y + 9 - pose.cartWheelBump, 16, 16};
+
+    Vector2 wheelLargePos = facingRight ? Vector2 {2, 18} : Vector2 {14, 18};
+    Vector2 wheelSmallPos = facingRight ? Vector2 {17, 20} : Vector2 {-1, 20};
+    Rectangle tractorBackDest = {rect.x + pose.narrow, rect.y - pose.bob, rect.width - pose.narrow * 2, rect.height + pose.tall};
+    Rectangle tractorFrontDest = tractorBackDest;
+    Rectangle wheelLargeDest = {rect.x + wheelLargePos.x , rect.y + wheelLargePos.y - (pose.wheelBump == 1), 16, 16};
+    Rectangle wheelSmallDest = {rect.x + wheelSmallPos.x , rect.y + wheelSmallPos.y - (pose.wheelBump == 2), 16, 16};
+
     if (flipTimer) {
         if (facingRight) {
             wheelSmallDest.x -= (float) flipTimer / 10 * 6;
@@ -261,15 +409,10 @@ void Tractor::Draw(Camera2D cam, bool updateAnimations) {
             tractorBackDest.width = rect.width - (float) flipTimer / 10 * 6;
             tractorFrontDest.width = rect.width - (float) flipTimer / 10 * 6;
         }
-        flipTimer--;
     }
 
     Color tintColor = color;
     if (isRainbow) {
-        rainbowTimer++;
-        if (rainbowTimer >= totalRainbowColors * 20)
-            rainbowTimer = 0;
-
         int currentColor = rainbowTimer / 20;
         tintColor = Morph((float) (rainbowTimer - currentColor) / ((currentColor + 1) * 20), rainbowColors[currentColor], rainbowColors[(currentColor + 1) % totalRainbowColors]);
     }
@@ -279,24 +422,18 @@ void Tractor::Draw(Camera2D cam, bool updateAnimations) {
     tractorBackDest.y += ySquish;
     tractorFrontDest.y += ySquish;
 
-    Texture2D halo = GetTexture(Textures::halo);
-    Vector2 haloPos = {rect.x + rect.width / 2 - halo.width / 2, rect.y + rect.height / 2 - halo.height / 2};
-    DrawTexture(halo, haloPos.x, haloPos.y, Color {252, 121, 20, 30});
-
-    DrawRectangle(lineStart.x, lineStart.y, lineEnd.x - lineStart.x, 2, Color {95, 52, 54, 255});
-    DrawTexturePro(GetTexture(Textures::wheelSmall), {0, 0, 16, 16}, cartWheelDest, {0, 0}, 0, WHITE);
-    DrawTexturePro(GetTexture(Textures::cart), {0, (float) (isLongWagon ? 32 : 0), (float) cartTexture.width, 32}, cartDest, {0, 0}, 0, WHITE);
+    batch.Draw(layer + 2, GetTexture(handles.wheelSmall), GetSourceRect(Textures::wheelSmall, {0, 0, 16, 16}), toScreenPos(cartWheelDest, cam), WHITE);
+    batch.Draw(layer + 3, cartTexture, GetSourceRect(Textures::cart, {0, (float) (isLongWagon ? 32 : 0), cartRect.width, 32}), toScreenPos(cartDest, cam), WHITE);
 
-    DrawTexturePro(GetTexture(Textures::tractor), Rectangle {0, 64, (float) (facingRight ? 32 : -32), 32}, tractorBackDest, {0, 0}, 0, WHITE);
-    DrawTexturePro(GetTexture(Textures::wheelLarge), Rectangle {0, 0, (float) (facingRight ? 16 : -16), 16}, wheelLargeDest, {0, 0}, 0, WHITE);
-    DrawTexturePro(GetTexture(Textures::wheelSmall), Rectangle {0, 0, (float) (facingRight ? 16 : -16), 16}, wheelSmallDest, {0, 0}, 0, WHITE);
-    DrawTexturePro(GetTexture(Textures::tractor), Rectangle {0, 0, (float) (facingRight ? 32 : -32), 32}, tractorFrontDest, {0, 0}, 0, tintColor);
-    DrawTexturePro(GetTexture(Textures::tractor), Rectangle {0, 32, (float) (facingRight ? 32 : -32), 32}, tractorFrontDest, {0, 0}, 0, WHITE);
+    batch.Draw(layer + 4, GetTexture(handles.tractor), GetSourceRect(Textures::tractor, {0, 64, (float) (facingRight ? 32 : -32), 32}), toScreenPos(tractorBackDest, cam), WHITE);
+    batch.Draw(layer + 5, GetTexture(handles.wheelLarge), GetSourceRect(Textures::wheelLarge, {0, 0, (float) (facingRight ? 16 : -16), 16}), toScreenPos(wheelLargeDest, cam), WHITE);
+    batch.Draw(layer + 6, GetTexture(handles.wheelSmall), GetSourceRect(Textures::wheelSmall, {0, 0, (float) (facingRight ? 16 : -16), 16}), toScreenPos(wheelSmallDest, cam), WHITE);
+    batch.Draw(layer + 7, GetTexture(handles.tractor), GetSourceRect(Textures::tractor, {0, 0, (float) (facingRight ? 32 : -32), 32}), toScreenPos(tractorFrontDest, cam), tintColor);
+    batch.Draw(layer + 8, GetTexture(handles.tractor), GetSourceRect(Textures::tractor, {0, 32, (float) (facingRight ? 32 : -32), 32}), toScreenPos(tractorFrontDest, cam), WHITE);
 }
 
-void Tractor::DrawParticles(Camera2D cam, bool updateParticles) {
-    if (updateParticles)
-        smokeParticleTimer--;
+void Tractor::UpdateParticles() {
+    smokeParticleTimer--;
 
     if (smokeParticleTimer < 0) {
         smokeParticleTimer = 30;
@@ -306,6 +443,7 @@ void Tractor::DrawParticles(Camera2D cam, bool updateParticles) {
             particle.lifetime = GetRandomValue(45, 50);
             particle.timer = 0;
             particle.pos = Vector2 {rect.x + (facingRight ? 12 : 20) + GetRandomValue(-4, 4), rect.y + 6 + GetRandomValue(-4, 4)};
+            particle.prevPos = particle.pos;
             particle.vel = Vector2 {0, -1.3};
             unsigned char greyness = (unsigned char) GetRandomValue(60, 120);
             particle.color = Color {greyness, greyness, greyness, 255};
@@ -316,29 +454,31 @@ void Tractor::DrawParticles(Camera2D cam, bool updateParticles) {
 
     for (int index = smokeParticlces.size() - 1; index >= 0; index--) {
         SmokeParticle &particle = smokeParticlces.at(index);
-        if (updateParticles)
-            particle.timer += 1;
+        particle.timer += 1;
         
         if (particle.timer > particle.lifetime) {
             smokeParticlces.erase(smokeParticlces.begin() + index);
             continue;
         }
-    
-        
-        if (updateParticles) {
-            particle.pos.x += particle.vel.x;
-            particle.pos.y += particle.vel.y;
-            particle.vel.y = Diminish(particle.vel.y, 0.025);
-        }
 
+        particle.pos.x += particle.vel.x;
+        particle.pos.y += particle.vel.y;
+        particle.vel.y = Diminish(particle.vel.y, 0.025);
         particle.color.a = (unsigned char) ((1 - ((float) particle.timer / (float) particle.lifetime)) * 100);
-        
-        float zoomLevel = cam.zoom / 4;
-        Vector2 relative = toScreenPos(Vector2 {particle.pos.x, particle.pos.y}, cam);
-        Texture2D smokeTexture = GetTexture(Textures::smoke);
-        DrawTextureEx(smokeTexture, Vector2 {
-            relative.x - (smokeTexture.width * zoomLevel) / 2, relative.y - (smokeTexture.height * zoomLevel) / 2}, 0, zoomLevel, 
-            particle.color);
+    }
+}
+
+void Tractor::DrawParticles(SpriteBatch &batch, Camera2D cam, float alpha) {
+    Texture2D &smokeTexture = GetTexture(GetSpriteHandles().smoke);
+    Rectangle smokeRect = GetTextureRect(Textures::smoke);
+    float zoomLevel = cam.zoom / 4;
+
+    for (SmokeParticle &particle : smokeParticlces) {
+        Vector2 relative = toScreenPos(Interpolate(particle.prevPos, particle.pos, alpha), cam);
+        Rectangle dest = {
+            relative.x - (smokeRect.width * zoomLevel) / 2, relative.y - (smokeRect.height * zoomLevel) / 2, 
+            smokeRect.width * zoomLevel, smokeRect.height * zoomLevel};
+        batch.Draw(SmokeLayer, smokeTexture, smokeRect, dest, particle.color);
     }
 }
 
@@ -347,11 +487,11 @@ Rectangle Tractor::GetTractorRect() {
 }
 
 Rectangle Tractor::GetCartRect() {
-    Texture2D &cartTexture = GetTexture(Textures::cart);
+    // Uses the sheet width directly so the cart rect is valid before any texture is loaded
     if (isLongWagon) {
-        return {cartX - cartTexture.width / 2 + 5, rect.y + 17, 38, 4};
+        return {cartX - cartSheetWidth / 2 + 5, rect.y + 17, 38, 4};
     }
 
-    return {cartX - cartTexture.width / 2 + 10, rect.y + 17, 28, 4};
+    return {cartX - cartSheetWidth / 2 + 10, rect.y + 17, 28, 4};
 }
 
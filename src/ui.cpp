@@ -1,21 +1,21 @@
 #include "ui.h"
 #include "debug.h"
 
-JakeFont::JakeFont(Texture2D text, std::string chars, int _spaceSize, Color splitColor) {
+JakeFont::JakeFont(Texture2D text, Rectangle region, std::string chars, int _spaceSize, Color splitColor) {
     texture = text;
     spaceSize = _spaceSize;
 
-    height = (float) text.height;
+    height = region.height;
 
     int characterIndex = 0;
     int begin = 0;
     int current = 1;
     Image image = LoadImageFromTexture(text);
-    while (current < text.width && characterIndex < (signed) chars.size()) {
-        Color pixelColor = GetImageColor(image, current, 0);
+    while (current < region.width && characterIndex < (signed) chars.size()) {
+        Color pixelColor = GetImageColor(image, region.x + current, region.y);
         if (pixelColor.r == splitColor.r && pixelColor.g == splitColor.g && pixelColor.b == splitColor.b && pixelColor.a == splitColor.a) {
             if (current > begin) {
-                letters[chars[characterIndex]] = Rectangle {(float) begin, 0, (float) current - begin, (float) text.height};
+                letters[chars[characterIndex]] = Rectangle {region.x + begin, region.y, (float) current - begin, region.height};
                 current++;
                 characterIndex++;
                 begin = current;
@@ -23,6 +23,7 @@ JakeFont::JakeFont(Texture2D text, std::string chars, int _spaceSize, Color spli
         }
         current++;
     }
+    UnloadImage(image);
 }
 
 int JakeFont::Measure(std::string text) {
@@ -41,11 +42,11 @@ int JakeFont::Measure(std::string text) {
     return width;
 }
 
-void JakeFont::Render(std::string text, Vector2 pos, float size, Color color) {
+void JakeFont::Render(std::string text, Vector2 pos, float size, Color color, SpriteBatch *batch, int layer) {
     for (char character : text) {
         if (character == '\n') {
             pos.x = 0;
-            pos.y += (texture.height + lineOffset) * size;
+            pos.y += (height + lineOffset) * size;
         } else if (character == ' ') {
             pos.x += spaceSize * size;
         } else if (character == '\t') {
@@ -53,7 +54,10 @@ void JakeFont::Render(std::string text, Vector2 pos, float size, Color color) {
         } else if (letters.find(character) != letters.end()) {
             Rectangle source = letters[character];
             Rectangle dest = {pos.x, pos.y, source.width * size, source.height * size};
-            DrawTexturePro(texture, source, dest, {0, 0}, 0, color);
+            if (batch)
+                batch->Draw(layer, texture, source, dest, color);
+            else
+                DrawTexturePro(texture, source, dest, {0, 0}, 0, color);
             pos.x += (source.width + letterDistance) * size;
         }
     }
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include "pch.h"
+#include "game.h"
+#include "items.h"
+#include "map.h"
+#include "mapcache.h"
+#include "post.h"
+#include "renderqueue.h"
+#include "shadercache.h"
+
+// Micro benchmarks, build with "make bench". Only the draw and shader benchmarks open a window, a hidden one
+
+using benchClock = std::chrono::steady_clock;
+
+void BenchItemStore(int liveItems, int ticks) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> xDist(0, 320);
+    std::uniform_real_distribution<float> yDist(-400, 144);
+    std::uniform_real_distribution<float> velDist(0.8, 2.5);
+    std::uniform_int_distribution<int> idDist(0, 50);
+
+    ItemStore store;
+    ItemEvents events;
+    store.Reserve(liveItems);
+    for (int i = 0; i < liveItems; i++) {
+        store.Add(Vector2 {xDist(rng), yDist(rng)}, idDist(rng), velDist(rng));
+    }
+
+    ItemStepInfo info = {Rectangle {150, 128, 28, 4}, 144, 0.8, true};
+    long long stepped = 0;
+
+    auto start = benchClock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        store.StorePrevious();
+        store.Step(info, events);
+        store.RemoveAll(events.removed);
+
+        // Keep the population steady like an item rain event would
+        while (store.Size() < liveItems) {
+            store.Add(Vector2 {xDist(rng), 0}, idDist(rng), velDist(rng));
+        }
+        stepped += store.Size();
+    }
+    double seconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    std::cout << "ItemStore " << liveItems << " items: "
+        << seconds * 1000 / ticks << " ms/tick, "
+        << seconds * 1e9 / stepped << " ns/item" << std::endl;
+}
+
+// Steps the game the way the fixed tick does with no window, audio device or assets. The cart
+// chases the lowest good item and a new game starts whenever one ends. Runs twice from the same
+// seed and both runs have to end the same
+bool BenchHeadlessGame(int ticks) {
+    RunState states[2];
+    int games[2] = {}, coins[2] = {}, sounds[2] = {};
+    double seconds = 0;
+    for (int run = 0; run < 2; run++) {
+        SetRandomSeed(1234);
+        auto start = benchClock::now();
+        for (int tick = 0; tick < ticks; tick++) {
+            if (tick == 0 || GetRunState().gameOver) {
+                if (tick > 0) coins[run] += GetGameData().inGameCoins;
+                GetGameData() = GameData {};
+                InitGame();
+                games[run]++;
+            }
+
+            ItemStore &items = GetFallingItems();
+            int lowest = -1;
+            for (int index = 0; index < items.Size(); index++) {
+                int id = items.ids[index];
+                bool bad = id == bombId || id == dynomiteId || (rottenFruitIds.x <= id && id <= rottenFruitIds.y);
+                if (bad || items.hitGround[index] || items.insideCart[index]) continue;
+                if (lowest < 0 || items.y[index] > items.y[lowest]) lowest = index;
+            }
+
+            TickInput input;
+            if (lowest >= 0) {
+                float offset = items.x[lowest] + itemTileSize / 2 - GetRunState().cartX;
+                input.right = offset > 4;
+                input.left = offset < -4;
+            }
+            StepGame(input);
+
+            sounds[run] += (int) GetTickSounds().size();
+            GetTickSounds().clear();
+        }
+        seconds += std::chrono::duration<double>(benchClock::now() - start).count();
+        states[run] = GetRunState();
+        coins[run] += states[run].coins;
+    }
+
+    RunState &state = states[1];
+    bool same = states[0].ticks == state.ticks && states[0].health == state.health && states[0].items == state.items
+        && states[0].tractorX == state.tractorX && states[0].cartX == state.cartX
+        && games[0] == games[1] && coins[0] == coins[1] && sounds[0] == sounds[1];
+    bool valid = state.health >= 0 && state.coins >= 0 && state.items >= 0;
+
+    std::cout << "Headless game " << ticks << " ticks: " << seconds * 1e6 / (ticks * 2) << " us/tick, "
+        << games[1] << " games, " << coins[1] << " coins, " << sounds[1] << " sounds"
+        << (same && valid ? "" : same ? " (FAILED: impossible state)" : " (FAILED: runs differ)") << std::endl;
+    return same && valid;
+}
+
+// What a tile lookup cost before the gid table, a scan over the tilesets then a divide and modulo
+Rectangle ScanSourceRect(TilesetCollection &collection, int gid) {
+    for (Tileset &tileset : collection.tilesets) {
+        if (tileset.startingGid <= gid && tileset.startingGid + tileset.tileCount > gid) {
+            return tileset.GetSourceRect(gid);
+        }
+    }
+    return Rectangle {};
+}
+
+void BenchGidLookup(int tilesetCount, int passes) {
+    TilesetCollection collection;
+    for (int index = 0; index < tilesetCount; index++) {
+        collection.AddTileset(Texture2D {0, 1024, 1024, 1, 7}, 16, 16);
+    }
+
+    // A 256x256 layer drawing from every tileset
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> gidDist(1, collection.tileCount);
+    std::vector<int> layer(256 * 256);
+    for (int &gid : layer) gid = gidDist(rng);
+
+    float checksum = 0;
+    auto start = benchClock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int gid : layer) checksum += ScanSourceRect(collection, gid).x;
+    }
+    double scanSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    start = benchClock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int gid : layer) checksum += collection.GetTile(gid).source.x;
+    }
+    double tableSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    long long lookups = (long long) layer.size() * passes;
+    std::cout << "Gid lookup " << tilesetCount << " tilesets: scan "
+        << scanSeconds * 1e9 / lookups << " ns/tile, table "
+        << tableSeconds * 1e9 / lookups << " ns/tile (" << checksum << ")" << std::endl;
+}
+
+void BenchDepthSort(int spriteCount, int frames) {
+    // Four layers of rows across a screen plus the sprites on it, somewhere far into the map
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> depthDist(8000, 8000 + 23 * 16);
+    std::vector<uint32_t> keys;
+    for (int layer = 0; layer < 4; layer++) {
+        for (int row = 0; row < 23; row++) keys.push_back(DepthKey(8000 + (row + layer) * 16.0f));
+    }
+    for (int sprite = 0; sprite < spriteCount; sprite++) keys.push_back(DepthKey(depthDist(rng)));
+
+    std::vector<int> order, scratch;
+    long long checksum = 0;
+    auto start = benchClock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        RadixSort(keys, order, scratch);
+        checksum += order[frame % order.size()];
+    }
+    double radixSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    start = benchClock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int index = 0; index < (int) keys.size(); index++) order[index] = index;
+        std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) { return keys[a] < keys[b]; });
+        checksum += order[frame % order.size()];
+    }
+    double stableSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    std::cout << "Depth sort " << keys.size() << " commands: radix "
+        << radixSeconds * 1e6 / frames << " us/frame, stable_sort "
+        << stableSeconds * 1e6 / frames << " us/frame (" << checksum << ")" << std::endl;
+}
+
+// Draws sprites in the order they were added, then through a RenderQueue sorting them by depth
+void BenchQueuedDraw(Texture2D texture, int spriteCount, int frames) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> xDist(0, 640 - 16);
+    std::uniform_real_distribution<float> yDist(0, 360 - 16);
+    std::vector<Rectangle> dests(spriteCount);
+    for (Rectangle &dest : dests) dest = Rectangle {xDist(rng), yDist(rng), 16, 16};
+
+    Rectangle source = {0, 0, 16, 16};
+    auto start = benchClock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        BeginDrawing();
+            ClearBackground(BLACK);
+            for (Rectangle &dest : dests) DrawTexturePro(texture, source, dest, Vector2 {0, 0}, 0, WHITE);
+        EndDrawing();
+    }
+    double directSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    RenderQueue queue;
+    TilesetCollection tilesets;
+    Camera2D camera = {};
+    camera.zoom = 1;
+    start = benchClock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        BeginDrawing();
+            ClearBackground(BLACK);
+            for (Rectangle &dest : dests) queue.AddSprite(texture, source, dest, dest.y + dest.height);
+            queue.Flush(tilesets, camera);
+        EndDrawing();
+    }
+    double queueSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    std::cout << "Queued draw " << spriteCount << " sprites: unsorted "
+        << directSeconds * 1e6 / frames << " us/frame, render queue "
+        << queueSeconds * 1e6 / frames << " us/frame" << std::endl;
+}
+
+// The first load of an effect combination the way a launch sees it, once with an empty cache
+// folder and once with the binary the first launch left behind. Each launch gets a fresh
+// ShaderCache, only the folder carries over
+void BenchShaderStartup(EffectSet effects) {
+    const char *folder = "bench_shadercache";
+    std::error_code error;
+    std::filesystem::remove_all(folder, error);
+    std::string fragmentCode = GenerateEffectShader(effects, GLSL_VERSION);
+
+    ShaderCache cold;
+    cold.Init(folder);
+    UnloadShader(cold.Load(fragmentCode));
+
+    ShaderCache warm;
+    warm.Init(folder);
+    UnloadShader(warm.Load(fragmentCode));
+
+    std::cout << "Shader startup " << TextFormat("%03x", effects) << ": cold "
+        << (cold.stats.compileTime + cold.stats.cacheTime) * 1000 << " ms, warm "
+        << (warm.stats.compileTime + warm.stats.cacheTime) * 1000 << " ms"
+        << (warm.stats.cached == 1 ? "" : " (no program binaries, compiled again)") << std::endl;
+    std::filesystem::remove_all(folder, error);
+}
+
+// Loads a generated map from the Tiled file and then from its compiled cache
+void BenchMapLoad(int size, int layerCount, int objectCount) {
+    const char *path = "bench_map.tmx";
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> gidDist(0, 255);
+    std::uniform_real_distribution<float> posDist(0, size * 16.0f);
+
+    {
+        std::ofstream out(path);
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+        out << "<map orientation=\"orthogonal\" renderorder=\"right-down\" width=\"" << size << "\" height=\"" << size << "\" tilewidth=\"16\" tileheight=\"16\">\n";
+        for (int layer = 0; layer < layerCount; layer++) {
+            out << " <layer id=\"" << layer + 1 << "\" name=\"layer" << layer << "\" width=\"" << size << "\" height=\"" << size << "\">\n";
+            out << "  <data encoding=\"csv\">\n";
+            for (int tile = 0; tile < size * size; tile++) {
+                out << gidDist(rng) << (tile + 1 < size * size ? "," : "") << ((tile + 1) % size == 0 ? "\n" : "");
+            }
+            out << "</data>\n </layer>\n";
+        }
+        out << " <objectgroup id=\"" << layerCount + 1 << "\" name=\"objects\">\n";
+        for (int object = 0; object < objectCount; object++) {
+            out << "  <object id=\"" << object + 1 << "\" name=\"crate" << object % 8 << "\" x=\"" << posDist(rng) << "\" y=\"" << posDist(rng) << "\" width=\"16\" height=\"16\"/>\n";
+        }
+        out << " </objectgroup>\n</map>\n";
+    }
+
+    auto start = benchClock::now();
+    Tilemap source = LoadMapSource(path);
+    double sourceSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    std::string cachePath = MapCachePath(path);
+    SaveMapCache(source, cachePath.c_str());
+
+    start = benchClock::now();
+    Tilemap cached = LoadMap(path);
+    double cacheSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    std::cout << "Map load " << size << "x" << size << " x" << layerCount << " layers: tmx "
+        << sourceSeconds * 1000 << " ms, lwmap " << cacheSeconds * 1000 << " ms ("
+        << cached.layers.size() << " layers)" << std::endl;
+
+    remove(path);
+    remove(cachePath.c_str());
+}
+
+std::string Base64Encode(const unsigned char *bytes, size_t size) {
+    const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    text.reserve((size + 2) / 3 * 4);
+    for (size_t index = 0; index < size; index += 3) {
+        unsigned int group = bytes[index] << 16;
+        if (index + 1 < size) group |= bytes[index + 1] << 8;
+        if (index + 2 < size) group |= bytes[index + 2];
+
+        text += alphabet[group >> 18 & 63];
+        text += alphabet[group >> 12 & 63];
+        text += index + 1 < size ? alphabet[group >> 6 & 63] : '=';
+        text += index + 2 < size ? alphabet[group & 63] : '=';
+    }
+    return text;
+}
+
+// Raylib's CompressData gives a bare deflate stream, Tiled's zlib wraps it in a header and an adler32
+std::string ZlibBase64(const std::vector<unsigned char> &bytes) {
+    int compressedSize = 0;
+    unsigned char *compressed = CompressData(bytes.data(), (int) bytes.size(), &compressedSize);
+
+    unsigned int a = 1, b = 0;
+    for (unsigned char byte : bytes) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    unsigned int adler = b << 16 | a;
+
+    std::vector<unsigned char> wrapped = {0x78, 0x9c};
+    wrapped.insert(wrapped.end(), compressed, compressed + compressedSize);
+    for (int shift : {24, 16, 8, 0}) wrapped.push_back((unsigned char) (adler >> shift));
+    MemFree(compressed);
+
+    return Base64Encode(wrapped.data(), wrapped.size());
+}
+
+// Loads a generated map with zlib compressed base64 layers, inflating them on one thread and then on every core
+void BenchCompressedMapLoad(int size, int layerCount) {
+    const char *path = "bench_zlib_map.tmx";
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> gidDist(0, 15);
+
+    {
+        std::ofstream out(path);
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+        out << "<map orientation=\"orthogonal\" renderorder=\"right-down\" width=\"" << size << "\" height=\"" << size << "\" tilewidth=\"16\" tileheight=\"16\">\n";
+        std::vector<unsigned char> bytes((size_t) size * size * 4);
+        for (int layer = 0; layer < layerCount; layer++) {
+            for (size_t tile = 0; tile < bytes.size(); tile += 4) {
+                bytes[tile] = (unsigned char) gidDist(rng);
+            }
+            out << " <layer id=\"" << layer + 1 << "\" name=\"layer" << layer << "\" width=\"" << size << "\" height=\"" << size << "\">\n";
+            out << "  <data encoding=\"base64\" compression=\"zlib\">\n   " << ZlibBase64(bytes) << "\n  </data>\n </layer>\n";
+        }
+        out << "</map>\n";
+    }
+
+    double seconds[2];
+    size_t loadedLayers[2];
+    for (int run = 0; run < 2; run++) {
+        layerDecodeThreads = run == 0 ? 1 : 0;
+        auto start = benchClock::now();
+        Tilemap map = LoadMapSource(path);
+        seconds[run] = std::chrono::duration<double>(benchClock::now() - start).count();
+
+        loadedLayers[run] = 0;
+        for (auto &[name, layer] : map.layers) {
+            if ((int) layer.tiles.size() == size * size) loadedLayers[run]++;
+        }
+    }
+    layerDecodeThreads = 0;
+
+    std::cout << "Zlib map load " << size << "x" << size << " x" << layerCount << " layers: 1 thread "
+        << seconds[0] * 1000 << " ms, " << std::thread::hardware_concurrency() << " threads " << seconds[1] * 1000
+        << " ms (" << loadedLayers[0] << " / " << loadedLayers[1] << " layers)" << std::endl;
+
+    remove(path);
+}
+
+void BenchObjectQuery(int zoneCount, int queries) {
+    // Spawn zones of a few tiles to a few screens across a 1024x1024 tile map
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> posDist(0, 1024 * 16.0f);
+    std::uniform_real_distribution<float> sizeDist(32, 1024);
+
+    ObjectLayer layer;
+    for (int zone = 0; zone < zoneCount; zone++) {
+        Object object;
+        object.id = zone + 1;
+        object.name = "spawn";
+        object.rect = Rectangle {posDist(rng), posDist(rng), sizeDist(rng), sizeDist(rng)};
+        layer.Add(object);
+    }
+
+    std::vector<Rectangle> views(queries);
+    for (Rectangle &view : views) view = Rectangle {posDist(rng), posDist(rng), 640, 360};
+
+    long long scanFound = 0;
+    auto start = benchClock::now();
+    for (Rectangle &view : views) {
+        for (Object &object : layer.objects) {
+            Rectangle &rect = object.rect;
+            if (rect.x <= view.x + view.width && rect.x + rect.width >= view.x
+                && rect.y <= view.y + view.height && rect.y + rect.height >= view.y) scanFound++;
+        }
+    }
+    double scanSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    long long gridFound = 0;
+    std::vector<Object*> found;
+    layer.Query(views[0], found);
+    start = benchClock::now();
+    for (Rectangle &view : views) {
+        found.clear();
+        layer.Query(view, found);
+        gridFound += found.size();
+    }
+    double gridSeconds = std::chrono::duration<double>(benchClock::now() - start).count();
+
+    std::cout << "Object query " << zoneCount << " zones: scan "
+        << scanSeconds * 1e9 / queries << " ns/query, grid "
+        << gridSeconds * 1e9 / queries << " ns/query (" << scanFound << " / " << gridFound << " found)" << std::endl;
+}
+
+int main() {
+    bool passed = BenchHeadlessGame(60 * 60 * 5);
+
+    for (int liveItems : {1000, 10000, 100000}) {
+        BenchItemStore(liveItems, 600);
+    }
+
+    for (int tilesetCount : {1, 4, 16}) {
+        BenchGidLookup(tilesetCount, 20);
+    }
+
+    for (int zoneCount : {100, 1000, 10000}) {
+        BenchObjectQuery(zoneCount, 10000);
+    }
+
+    for (int spriteCount : {100, 1000, 10000}) {
+        BenchDepthSort(spriteCount, 1000);
+    }
+
+    // Drawing and shaders need a window, a hidden one does
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(640, 360, "bench");
+    Image image = GenImageColor(16, 16, WHITE);
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    for (int spriteCount : {100, 1000, 10000}) {
+        BenchQueuedDraw(texture, spriteCount, 300);
+    }
+    UnloadTexture(texture);
+    for (EffectSet effects : {EffectBit(FX_GRAYSCALE), EffectBit(FX_SCANLINES) | EffectBit(FX_BLOOM),
+            EffectBit(FX_FISHEYE) | EffectBit(FX_SOBEL) | EffectBit(FX_BLUR) | EffectBit(FX_POSTERIZATION)}) {
+        BenchShaderStartup(effects);
+    }
+    CloseWindow();
+
+    BenchMapLoad(1024, 4, 2000);
+    BenchCompressedMapLoad(4096, 4);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#include <filesystem>
+#include "pch.h"
+#include "map.h"
+#include "mapcache.h"
+
+// Compiles every .tmx and .tsx under resources/ into a .lwmap next to it, build and run with "make maps".
+// Streamed maps also get a .chunks folder of chunk files
+
+int main(int argc, char **argv) {
+    const char *resourcesFolder = argc > 1 ? argv[1] : "resources";
+    SetTraceLogLevel(LOG_WARNING);
+
+    int compiled = 0;
+    for (auto &file : std::filesystem::recursive_directory_iterator(resourcesFolder)) {
+        if (!file.is_regular_file()) continue;
+
+        std::string path = file.path().lexically_normal().generic_string();
+        std::string extension = file.path().extension().string();
+        if (extension != ".tmx" && extension != ".tsx") continue;
+        if (IsMapCacheFresh(path.c_str())) continue;
+
+        std::string cachePath = MapCachePath(path.c_str());
+        bool saved;
+        if (extension == ".tmx") {
+            // Maps with a "streamed" bool property set in Tiled are paged in chunk by chunk
+            Tilemap map = LoadMapSource(path.c_str());
+            if (map.properties.GetBool(InternProperty("streamed")))
+                saved = SaveStreamedMapCache(map, cachePath.c_str(), ChunkFolderPath(path.c_str()).c_str());
+            else
+                saved = SaveMapCache(map, cachePath.c_str());
+        } else {
+            Tileset tileset = LoadSetSource(path.c_str());
+            saved = SaveTilesetCache(tileset, cachePath.c_str());
+        }
+
+        if (!saved) {
+            std::cout << "Failed to write " << cachePath << std::endl;
+            return 1;
+        }
+        compiled++;
+    }
+
+    std::cout << "Compiled " << compiled << " maps and tilesets" << std::endl;
+    return 0;
+}
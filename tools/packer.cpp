@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "pch.h"
+#include "bundle.h"
+
+// Packs everything under resources/ into one bundle, build and run with "make bundle"
+
+struct PackedAsset {
+    BundleEntry entry;
+    std::vector<unsigned char> data;
+};
+
+bool PackImage(const std::string &path, PackedAsset &asset) {
+    Image image = LoadImage(path.c_str());
+    if (!image.data) return false;
+
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    asset.entry.type = BundleImage;
+    asset.entry.format = image.format;
+    asset.entry.width = image.width;
+    asset.entry.height = image.height;
+
+    unsigned char *pixels = (unsigned char *) image.data;
+    asset.data.assign(pixels, pixels + GetPixelDataSize(image.width, image.height, image.format));
+    UnloadImage(image);
+    return true;
+}
+
+bool PackWave(const std::string &path, PackedAsset &asset) {
+    Wave wave = LoadWave(path.c_str());
+    if (!wave.data) return false;
+
+    // 16 bit is what raylib converts to on upload anyway
+    if (wave.sampleSize != 16) WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+    asset.entry.type = BundleWave;
+    asset.entry.frameCount = wave.frameCount;
+    asset.entry.sampleRate = wave.sampleRate;
+    asset.entry.sampleSize = wave.sampleSize;
+    asset.entry.channels = wave.channels;
+
+    unsigned char *samples = (unsigned char *) wave.data;
+    asset.data.assign(samples, samples + wave.frameCount * wave.channels * wave.sampleSize / 8);
+    UnloadWave(wave);
+    return true;
+}
+
+bool PackText(const std::string &path, PackedAsset &asset) {
+    char *text = LoadFileText(path.c_str());
+    if (!text) return false;
+
+    asset.entry.type = BundleText;
+    asset.data.assign(text, text + strlen(text) + 1);
+    UnloadFileText(text);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *resourcesFolder = argc > 1 ? argv[1] : "resources";
+    const char *bundlePath = argc > 2 ? argv[2] : "assets.lwb";
+    SetTraceLogLevel(LOG_WARNING);
+
+    std::vector<PackedAsset> assets;
+    for (auto &file : std::filesystem::recursive_directory_iterator(resourcesFolder)) {
+        if (!file.is_regular_file()) continue;
+
+        std::string path = file.path().lexically_normal().generic_string();
+        std::string extension = file.path().extension().string();
+        if (path.size() >= bundleNameLength) {
+            std::cout << "Skipping " << path << ", the path is too long" << std::endl;
+            continue;
+        }
+
+        PackedAsset asset = {};
+        strncpy(asset.entry.name, path.c_str(), bundleNameLength - 1);
+
+        bool packed = false;
+        if (extension == ".png")
+            packed = PackImage(path, asset);
+        else if (extension == ".mp3" || extension == ".wav" || extension == ".ogg")
+            packed = PackWave(path, asset);
+        else if (extension == ".fs" || extension == ".vs")
+            packed = PackText(path, asset);
+        else
+            continue;
+
+        if (!packed) {
+            std::cout << "Failed to pack " << path << std::endl;
+            return 1;
+        }
+        assets.push_back(std::move(asset));
+    }
+
+    // Sorted names let the game binary search the index
+    std::sort(assets.begin(), assets.end(), [](const PackedAsset &a, const PackedAsset &b) {
+        return strcmp(a.entry.name, b.entry.name) < 0;
+    });
+
+    uint64_t offset = sizeof(BundleHeader) + assets.size() * sizeof(BundleEntry);
+    for (PackedAsset &asset : assets) {
+        offset = (offset + bundleAlignment - 1) / bundleAlignment * bundleAlignment;
+        asset.entry.offset = offset;
+        asset.entry.size = asset.data.size();
+        offset += asset.data.size();
+    }
+
+    std::ofstream out(bundlePath, std::ios::binary);
+    BundleHeader header = {};
+    memcpy(header.magic, bundleMagic, 4);
+    header.version = bundleVersion;
+    header.entryCount = (uint32_t) assets.size();
+    out.write((const char *) &header, sizeof(header));
+
+    for (PackedAsset &asset : assets) {
+        out.write((const char *) &asset.entry, sizeof(BundleEntry));
+    }
+
+    for (PackedAsset &asset : assets) {
+        while ((uint64_t) out.tellp() < asset.entry.offset) out.put(0);
+        out.write((const char *) asset.data.data(), asset.data.size());
+    }
+
+    std::cout << "Packed " << assets.size() << " assets into " << bundlePath << " (" << offset / 1024 << " KiB)" << std::endl;
+    return 0;
+}